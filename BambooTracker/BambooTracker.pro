@@ -49,6 +49,7 @@ SOURCES += \
     chips/resampler.cpp \
     chips/mame/2608intf.c \
     chips/mame/emu2149.c \
+    chips/mame/blep2149.c \
     chips/mame/fm.c \
     chips/mame/ymdeltat.c \
     bamboo_tracker.cpp \
@@ -164,6 +165,14 @@ SOURCES += \
     gui/comment_edit_dialog.cpp \
     io/file_io.cpp \
     io/binary_container.cpp \
+    io/mapped_file.cpp \
+    io/binary_file_writer.cpp \
+    io/lz_codec.cpp \
+    instrument/instrument_user_set.cpp \
+    module/pattern_cells.cpp \
+    module/step_timeline.cpp \
+    command/pattern/pattern_cells_backup.cpp \
+    command/compound_command.cpp \
     gui/command/pattern/interpolate_pattern_qt_command.cpp \
     command/pattern/interpolate_pattern_command.cpp \
     gui/command/pattern/reverse_pattern_qt_command.cpp \
@@ -194,6 +203,7 @@ HEADERS += \
     gui/mainwindow.hpp \
     chips/mame/2608intf.h \
     chips/mame/emu2149.h \
+    chips/mame/blep2149.h \
     chips/mame/emutypes.h \
     chips/mame/fm.h \
     chips/mame/mamedef.h \
@@ -325,6 +335,16 @@ HEADERS += \
     gui/comment_edit_dialog.hpp \
     io/file_io.hpp \
     io/binary_container.hpp \
+    io/mapped_file.hpp \
+    io/binary_file_writer.hpp \
+    io/lz_codec.hpp \
+    instrument/instrument_property_table.hpp \
+    instrument/instrument_user_set.hpp \
+    module/pattern_cells.hpp \
+    module/step_timeline.hpp \
+    gui/clipboard_format.hpp \
+    command/pattern/pattern_cells_backup.hpp \
+    command/compound_command.hpp \
     version.hpp \
     gui/command/pattern/interpolate_pattern_qt_command.hpp \
     command/pattern/interpolate_pattern_command.hpp \
@@ -9,9 +9,30 @@
 
 const uint32_t BambooTracker::CHIP_CLOCK = 3993600 * 2;
 
+/// Stored settings may come from another version or be edited by hand
+static chip::SSGEmulator toSSGEmulator(int value)
+{
+	switch (value) {
+	case static_cast<int>(chip::SSGEmulator::BLEP):	return chip::SSGEmulator::BLEP;
+	default:										return chip::SSGEmulator::EMU2149;
+	}
+}
+
+static chip::MixMode toMixMode(int value)
+{
+	switch (value) {
+	case static_cast<int>(chip::MixMode::SINGLE_RESAMPLE):	return chip::MixMode::SINGLE_RESAMPLE;
+	case static_cast<int>(chip::MixMode::INTEGER_RATIO):	return chip::MixMode::INTEGER_RATIO;
+	default:												return chip::MixMode::SEPARATE;
+	}
+}
+
 BambooTracker::BambooTracker(std::weak_ptr<Configuration> config)
 	: instMan_(std::make_shared<InstrumentsManager>()),
 	  mod_(std::make_shared<Module>()),
+	  timelineChangeCnt_(0),
+	  isModLoadCanceled_(false),
+	  modLoadProgress_(0),
 	  octave_(4),
 	  curSongNum_(0),
 	  curTrackNum_(0),
@@ -27,7 +48,9 @@ BambooTracker::BambooTracker(std::weak_ptr<Configuration> config)
 	opnaCtrl_ = std::make_unique<OPNAController>(
 					CHIP_CLOCK,
 					config.lock()->getSampleRate(),
-					config.lock()->getBufferLength());
+					config.lock()->getBufferLength(),
+					toSSGEmulator(config.lock()->getSSGEmulator()));
+	opnaCtrl_->setMixMode(toMixMode(config.lock()->getMixMode()));
 	setMasterVolume(config.lock()->getMixerVolumeMaster());
 	setMasterVolumeFM(config.lock()->getMixerVolumeFM());
 	setMasterVolumeSSG(config.lock()->getMixerVolumeSSG());
@@ -44,6 +67,7 @@ void BambooTracker::changeConfiguration(std::weak_ptr<Configuration> config)
 {
 	setStreamRate(config.lock()->getSampleRate());
 	setStreamDuration(config.lock()->getBufferLength());
+	opnaCtrl_->setMixMode(toMixMode(config.lock()->getMixMode()));
 	setMasterVolume(config.lock()->getMixerVolumeMaster());
 	setMasterVolumeFM(config.lock()->getMixerVolumeFM());
 	setMasterVolumeSSG(config.lock()->getMixerVolumeSSG());
@@ -96,11 +120,9 @@ void BambooTracker::removeInstrument(int num)
 	comMan_.invoke(std::make_unique<RemoveInstrumentCommand>(instMan_, num));
 }
 
-std::unique_ptr<AbstractInstrument> BambooTracker::getInstrument(int num)
+std::shared_ptr<const AbstractInstrument> BambooTracker::getInstrument(int num)
 {
-	std::shared_ptr<AbstractInstrument> inst = instMan_->getInstrumentSharedPtr(num);
-	if (inst == nullptr) return std::unique_ptr<AbstractInstrument>();
-	else return inst->clone();
+	return instMan_->getInstrumentSnapshot(num);
 }
 
 void BambooTracker::cloneInstrument(int num, int refNum)
@@ -116,6 +138,7 @@ void BambooTracker::deepCloneInstrument(int num, int refNum)
 void BambooTracker::loadInstrument(std::string path, int instNum)
 {
 	auto inst = InstrumentIO::loadInstrument(path, instMan_, instNum);
+	instMan_->reuseIdenticalProperties(inst);
 	comMan_.invoke(std::make_unique<AddInstrumentCommand>(
 					   instMan_, std::unique_ptr<AbstractInstrument>(inst)));
 }
@@ -128,10 +151,55 @@ void BambooTracker::saveInstrument(std::string path, int instNum)
 void BambooTracker::importInstrument(const AbstractBank &bank, size_t index, int instNum)
 {
 	auto inst = bank.loadInstrument(index, instMan_, instNum);
+	instMan_->reuseIdenticalProperties(inst);
 	comMan_.invoke(std::make_unique<AddInstrumentCommand>(
 					   instMan_, std::unique_ptr<AbstractInstrument>(inst)));
 }
 
+void BambooTracker::loadInstruments(std::vector<std::string> paths, std::vector<int>& instNums)
+{
+	addInstruments(paths.size(), [&](size_t i, int n) {
+		return InstrumentIO::loadInstrument(paths[i], instMan_, n);
+	}, instNums);
+}
+
+void BambooTracker::importInstruments(const AbstractBank &bank, std::vector<size_t> indices,
+									  std::vector<int>& instNums)
+{
+	addInstruments(indices.size(), [&](size_t i, int n) {
+		return bank.loadInstrument(indices[i], instMan_, n);
+	}, instNums);
+}
+
+void BambooTracker::addInstruments(size_t count, std::function<AbstractInstrument*(size_t, int)> load,
+								   std::vector<int>& instNums)
+{
+	instNums.clear();
+
+	std::vector<int> freeNums;
+	for (int n = 0; n < 128; ++n) {
+		if (!instMan_->getInstrumentSharedPtr(n)) freeNums.push_back(n);
+	}
+	if (count > freeNums.size()) count = freeNums.size();
+
+	// Undo all loaded instruments at once
+	comMan_.beginCompound();
+	try {
+		for (size_t i = 0; i < count; ++i) {
+			int n = freeNums[i];
+			std::unique_ptr<AbstractInstrument> inst(load(i, n));
+			instMan_->reuseIdenticalProperties(inst.get());
+			comMan_.invoke(std::make_unique<AddInstrumentCommand>(instMan_, std::move(inst)));
+			instNums.push_back(n);
+		}
+	}
+	catch (...) {
+		comMan_.endCompound();
+		throw;
+	}
+	comMan_.endCompound();
+}
+
 int BambooTracker::findFirstFreeInstrumentNumber() const
 {
 	return instMan_->findFirstFreeInstrument();
@@ -187,7 +255,7 @@ void BambooTracker::setInstrumentFMEnvelope(int instNum, int envNum)
 	opnaCtrl_->updateInstrumentFM(instNum);
 }
 
-std::vector<int> BambooTracker::getEnvelopeFMUsers(int envNum) const
+InstrumentUserSet BambooTracker::getEnvelopeFMUsers(int envNum) const
 {
 	return instMan_->getEnvelopeFMUsers(envNum);
 }
@@ -210,7 +278,7 @@ void BambooTracker::setInstrumentFMLFO(int instNum, int lfoNum)
 	opnaCtrl_->updateInstrumentFM(instNum);
 }
 
-std::vector<int> BambooTracker::getLFOFMUsers(int lfoNum) const
+InstrumentUserSet BambooTracker::getLFOFMUsers(int lfoNum) const
 {
 	return instMan_->getLFOFMUsers(lfoNum);
 }
@@ -252,7 +320,7 @@ void BambooTracker::setInstrumentFMOperatorSequenceEnabled(int instNum, FMEnvelo
 	opnaCtrl_->updateInstrumentFM(instNum);
 }
 
-std::vector<int> BambooTracker::getOperatorSequenceFMUsers(FMEnvelopeParameter param, int opSeqNum) const
+InstrumentUserSet BambooTracker::getOperatorSequenceFMUsers(FMEnvelopeParameter param, int opSeqNum) const
 {
 	return instMan_->getOperatorSequenceFMUsers(param, opSeqNum);
 }
@@ -299,7 +367,7 @@ void BambooTracker::setInstrumentFMArpeggioEnabled(int instNum, bool enabled)
 	opnaCtrl_->updateInstrumentFM(instNum);
 }
 
-std::vector<int> BambooTracker::getArpeggioFMUsers(int arpNum) const
+InstrumentUserSet BambooTracker::getArpeggioFMUsers(int arpNum) const
 {
 	return instMan_->getArpeggioFMUsers(arpNum);
 }
@@ -346,7 +414,7 @@ void BambooTracker::setInstrumentFMPitchEnabled(int instNum, bool enabled)
 	opnaCtrl_->updateInstrumentFM(instNum);
 }
 
-std::vector<int> BambooTracker::getPitchFMUsers(int ptNum) const
+InstrumentUserSet BambooTracker::getPitchFMUsers(int ptNum) const
 {
 	return instMan_->getPitchFMUsers(ptNum);
 }
@@ -395,7 +463,7 @@ void BambooTracker::setInstrumentSSGWaveFormEnabled(int instNum, bool enabled)
 	opnaCtrl_->updateInstrumentSSG(instNum);
 }
 
-std::vector<int> BambooTracker::getWaveFormSSGUsers(int wfNum) const
+InstrumentUserSet BambooTracker::getWaveFormSSGUsers(int wfNum) const
 {
 	return instMan_->getWaveFormSSGUsers(wfNum);
 }
@@ -437,7 +505,7 @@ void BambooTracker::setInstrumentSSGToneNoiseEnabled(int instNum, bool enabled)
 	opnaCtrl_->updateInstrumentSSG(instNum);
 }
 
-std::vector<int> BambooTracker::getToneNoiseSSGUsers(int tnNum) const
+InstrumentUserSet BambooTracker::getToneNoiseSSGUsers(int tnNum) const
 {
 	return instMan_->getToneNoiseSSGUsers(tnNum);
 }
@@ -479,7 +547,7 @@ void BambooTracker::setInstrumentSSGEnvelopeEnabled(int instNum, bool enabled)
 	opnaCtrl_->updateInstrumentSSG(instNum);
 }
 
-std::vector<int> BambooTracker::getEnvelopeSSGUsers(int envNum) const
+InstrumentUserSet BambooTracker::getEnvelopeSSGUsers(int envNum) const
 {
 	return instMan_->getEnvelopeSSGUsers(envNum);
 }
@@ -526,7 +594,7 @@ void BambooTracker::setInstrumentSSGArpeggioEnabled(int instNum, bool enabled)
 	opnaCtrl_->updateInstrumentSSG(instNum);
 }
 
-std::vector<int> BambooTracker::getArpeggioSSGUsers(int arpNum) const
+InstrumentUserSet BambooTracker::getArpeggioSSGUsers(int arpNum) const
 {
 	return instMan_->getArpeggioSSGUsers(arpNum);
 }
@@ -573,7 +641,7 @@ void BambooTracker::setInstrumentSSGPitchEnabled(int instNum, bool enabled)
 	opnaCtrl_->updateInstrumentSSG(instNum);
 }
 
-std::vector<int> BambooTracker::getPitchSSGUsers(int ptNum) const
+InstrumentUserSet BambooTracker::getPitchSSGUsers(int ptNum) const
 {
 	return instMan_->getPitchSSGUsers(ptNum);
 }
@@ -593,6 +661,7 @@ void BambooTracker::setCurrentSongNumber(int num)
 
 	auto& song = mod_->getSong(curSongNum_);
 	songStyle_ = song.getStyle();
+	timelines_.clear();
 
 	jamMan_->clear(songStyle_.type);
 
@@ -671,6 +740,12 @@ void BambooTracker::redo()
 	comMan_.redo();
 }
 
+/// Oldest commands may be discarded by the memory limit of the history
+bool BambooTracker::canUndo() const
+{
+	return comMan_.canUndo();
+}
+
 void BambooTracker::clearCommandHistory()
 {
 	comMan_.clear();
@@ -905,7 +980,7 @@ bool BambooTracker::exportToWav(std::string file, int loopCnt, std::function<boo
 
 	int endOrder = 0;
 	int endStep = 0;
-	checkNextPositionOfLastStep(endOrder, endStep);
+	checkNextPositionOfLastStep(curSongNum_, endOrder, endStep);
 	bool endFlag = false;
 	bool tmpFollow = isFollowPlay_;
 	isFollowPlay_ = false;
@@ -967,7 +1042,7 @@ bool BambooTracker::exportToVgm(std::string file, bool gd3TagEnabled, GD3Tag tag
 
 	int loopOrder = 0;
 	int loopStep = 0;
-	checkNextPositionOfLastStep(loopOrder, loopStep);
+	checkNextPositionOfLastStep(curSongNum_, loopOrder, loopStep);
 	bool loopFlag = (loopOrder != -1);
 	int endCnt = (loopOrder == -1) ? 0 : 1;
 	bool tmpFollow = isFollowPlay_;
@@ -1024,7 +1099,7 @@ bool BambooTracker::exportToS98(std::string file, bool tagEnabled, S98Tag tag, s
 
 	int loopOrder = 0;
 	int loopStep = 0;
-	checkNextPositionOfLastStep(loopOrder, loopStep);
+	checkNextPositionOfLastStep(curSongNum_, loopOrder, loopStep);
 	bool loopFlag = (loopOrder != -1);
 	int endCnt = (loopOrder == -1) ? 0 : 1;
 	bool tmpFollow = isFollowPlay_;
@@ -1069,15 +1144,17 @@ bool BambooTracker::exportToS98(std::string file, bool tagEnabled, S98Tag tag, s
 	}
 }
 
-void BambooTracker::checkNextPositionOfLastStep(int& endOrder, int& endStep) const
+void BambooTracker::checkNextPositionOfLastStep(int songNum, int& endOrder, int& endStep) const
 {
-	Song& song = mod_->getSong(curSongNum_);
+	Song& song = mod_->getSong(songNum);
+	std::shared_ptr<const StepTimeline> timeline = getStepTimeline(songNum);
 	int lastOrder = song.getOrderSize() - 1;
-	int lastStep = getPatternSizeFromOrderNumber(curSongNum_, lastOrder) - 1;
+	int lastStep = timeline->getPatternSize(lastOrder) - 1;
 	endOrder = 0;
 	endStep = 0;
-	for (auto attrib : songStyle_.trackAttribs) {
-		Step& step = song.getTrack(attrib.number).getPatternFromOrderNumber(lastOrder).getStep(lastStep);
+	for (auto attrib : song.getStyle().trackAttribs) {
+		const Pattern& ptn = song.getTrack(attrib.number).getPatternFromOrderNumber(lastOrder);
+		const Step& step = ptn.getStep(lastStep);
 		for (int i = 0; i < 4; ++i) {
 			int effVal = step.getEffectValue(i);
 			if (effVal != -1) {
@@ -1090,7 +1167,7 @@ void BambooTracker::checkNextPositionOfLastStep(int& endOrder, int& endStep) con
 					endOrder = -1;
 					endStep = -1;
 				}
-				else if (effId == "0D" && effVal < getPatternSizeFromOrderNumber(curSongNum_, 0)) {
+				else if (effId == "0D" && effVal < timeline->getPatternSize(0)) {
 					endOrder = 0;
 					endStep = effVal;
 				}
@@ -1157,8 +1234,8 @@ void BambooTracker::readTick(int rest)
 
 	auto& song = mod_->getSong(curSongNum_);
 	for (auto& attrib : songStyle_.trackAttribs) {
-		auto& curStep = song.getTrack(attrib.number)
-						.getPatternFromOrderNumber(playOrderNum_).getStep(playStepNum_);
+		const Pattern& ptn = song.getTrack(attrib.number).getPatternFromOrderNumber(playOrderNum_);
+		const Step& curStep = ptn.getStep(playStepNum_);
 		switch (attrib.source) {
 		case SoundSource::FM:
 		{
@@ -1208,8 +1285,8 @@ void BambooTracker::readTick(int rest)
 
 		if (rest == 1 && nextReadOrder_ != -1 && attrib.source == SoundSource::FM) {
 			// Channel envelope reset before next key on
-			auto& step = song.getTrack(attrib.number)
-						 .getPatternFromOrderNumber(nextReadOrder_).getStep(nextReadStep_);
+			const Pattern& ptn = song.getTrack(attrib.number).getPatternFromOrderNumber(nextReadOrder_);
+			const Step& step = ptn.getStep(nextReadStep_);
 			int n = step.checkEffectID("0G");
 			if (n == -1 || !step.getEffectValue(n)) {
 				envelopeResetEffectFM(step, attrib.channelInSource);
@@ -1224,7 +1301,7 @@ void BambooTracker::readTick(int rest)
 	}
 }
 
-void BambooTracker::readTickFMForNoteDelay(Step& step, int ch)
+void BambooTracker::readTickFMForNoteDelay(const Step& step, int ch)
 {
 	int cnt = ntDlyCntFM_[ch];
 	if (!cnt) {
@@ -1236,7 +1313,7 @@ void BambooTracker::readTickFMForNoteDelay(Step& step, int ch)
 	}
 }
 
-void BambooTracker::envelopeResetEffectFM(Step& step, int ch)
+void BambooTracker::envelopeResetEffectFM(const Step& step, int ch)
 {
 	int n = step.getNoteNumber();
 	if ((n >= 0 || n < -2)
@@ -1310,7 +1387,8 @@ void BambooTracker::retrieveChannelStates()
 
 	while (true) {
 		for (auto it = songStyle_.trackAttribs.rbegin(), e = songStyle_.trackAttribs.rend(); it != e; ++it) {
-			Step& step = song.getTrack(it->number).getPatternFromOrderNumber(o).getStep(s);
+			const Pattern& ptn = song.getTrack(it->number).getPatternFromOrderNumber(o);
+			const Step& step = ptn.getStep(s);
 
 			switch (it->source) {
 			case SoundSource::FM:
@@ -1614,8 +1692,8 @@ void BambooTracker::readStep()
 
 	auto& song = mod_->getSong(curSongNum_);
 	for (auto& attrib : songStyle_.trackAttribs) {
-		auto& step = song.getTrack(attrib.number)
-					 .getPatternFromOrderNumber(playOrderNum_).getStep(playStepNum_);
+		const Pattern& ptn = song.getTrack(attrib.number).getPatternFromOrderNumber(playOrderNum_);
+		const Step& step = ptn.getStep(playStepNum_);
 		switch (attrib.source) {
 		case SoundSource::FM:
 		{
@@ -1664,7 +1742,7 @@ void BambooTracker::readStep()
 	isFindNextStep_ = isNextSet;
 }
 
-bool BambooTracker::readFMStep(Step& step, int ch, bool isSkippedSpecial)
+bool BambooTracker::readFMStep(const Step& step, int ch, bool isSkippedSpecial)
 {
 	bool isNextSet = false;
 
@@ -1716,7 +1794,7 @@ bool BambooTracker::readFMStep(Step& step, int ch, bool isSkippedSpecial)
 	return isNextSet;
 }
 
-bool BambooTracker::readSSGStep(Step& step, int ch, bool isSkippedSpecial)
+bool BambooTracker::readSSGStep(const Step& step, int ch, bool isSkippedSpecial)
 {
 	bool isNextSet = false;
 
@@ -1768,7 +1846,7 @@ bool BambooTracker::readSSGStep(Step& step, int ch, bool isSkippedSpecial)
 	return isNextSet;
 }
 
-bool BambooTracker::readDrumStep(Step& step, int ch, bool isSkippedSpecial)
+bool BambooTracker::readDrumStep(const Step& step, int ch, bool isSkippedSpecial)
 {
 	bool isNextSet = false;
 
@@ -2192,9 +2270,66 @@ void BambooTracker::loadModule(std::string path)
 	if (ep) std::rethrow_exception(ep);
 }
 
-void BambooTracker::saveModule(std::string path)
+void BambooTracker::startLoadingModule(std::string path)
+{
+	if (isLoadingModule()) return;
+
+	loadingMod_ = std::make_shared<Module>();
+	loadingInstMan_ = std::make_shared<InstrumentsManager>();
+	isModLoadCanceled_ = false;
+	modLoadProgress_ = 0;
+
+	std::shared_ptr<Module> mod = loadingMod_;
+	std::shared_ptr<InstrumentsManager> instMan = loadingInstMan_;
+	modLoader_ = std::async(std::launch::async, [this, path, mod, instMan]() -> bool {
+		return ModuleIO::loadModule(path, mod, instMan, [this](size_t loaded, size_t whole) -> bool {
+			if (whole) modLoadProgress_ = static_cast<int>(loaded * 100 / whole);
+			return isModLoadCanceled_;
+		});
+	});
+}
+
+bool BambooTracker::isLoadingModule() const
+{
+	return modLoader_.valid()
+			&& modLoader_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+int BambooTracker::getModuleLoadingProgress() const
+{
+	return modLoadProgress_;
+}
+
+void BambooTracker::cancelLoadingModule()
+{
+	isModLoadCanceled_ = true;
+}
+
+bool BambooTracker::finishLoadingModule()
+{
+	if (!modLoader_.valid()) return false;
+
+	std::shared_ptr<Module> mod = std::move(loadingMod_);
+	std::shared_ptr<InstrumentsManager> instMan = std::move(loadingInstMan_);
+	if (!modLoader_.get()) return false;	// Rethrow the error of loading
+
+	stopPlaySong();
+	opnaCtrl_->reset();
+
+	instMan_ = instMan;
+	mod_ = mod;
+
+	tickCounter_.setInterruptRate(mod_->getTickFrequency());
+	setCurrentSongNumber(0);
+	curInstNum_ = -1;
+	clearCommandHistory();
+
+	return true;
+}
+
+void BambooTracker::saveModule(std::string path, bool isCompressed)
 {
-	ModuleIO::saveModule(path, mod_, instMan_);
+	ModuleIO::saveModule(path, mod_, instMan_, isCompressed);
 }
 
 void BambooTracker::setModulePath(std::string path)
@@ -2366,29 +2501,21 @@ void BambooTracker::addSong(SongType songType, std::string title)
 void BambooTracker::sortSongs(std::vector<int> numbers)
 {
 	mod_->sortSongs(std::move(numbers));
+	timelines_.clear();
 }
 
 size_t BambooTracker::getAllStepCount(int songNum, int loopCnt) const
 {
-	size_t os = getOrderSize(songNum);
+	std::shared_ptr<const StepTimeline> timeline = getStepTimeline(songNum);
 	int loopOrder = 0;
 	int loopStep = 0;
-	checkNextPositionOfLastStep(loopOrder, loopStep);
+	checkNextPositionOfLastStep(songNum, loopOrder, loopStep);
 	if (loopOrder == -1) {
-		size_t stepCnt = 0;
-		for (size_t i = 0; i < os; ++i)
-			stepCnt += getPatternSizeFromOrderNumber(songNum, i);
-		return stepCnt;
+		return timeline->getStepCount();
 	}
 	else {
-		size_t introStepCnt = 0;
-		for (int i = 0; i < loopOrder; ++i)
-			introStepCnt += getPatternSizeFromOrderNumber(curSongNum_, i);
-		introStepCnt += loopStep;
-		size_t loopStepCnt = getPatternSizeFromOrderNumber(curSongNum_, loopOrder) - loopStep;
-		for (size_t i = loopOrder + 1; i < os; ++i) {
-			loopStepCnt += getPatternSizeFromOrderNumber(songNum, i);
-		}
+		size_t introStepCnt = timeline->getAbsoluteStep(loopOrder, loopStep);
+		size_t loopStepCnt = timeline->getStepCount() - introStepCnt;
 		return introStepCnt + loopStepCnt * loopCnt;
 	}
 }
@@ -2415,10 +2542,10 @@ void BambooTracker::deleteOrder(int songNum, int orderNum)
 }
 
 void BambooTracker::pasteOrderCells(int songNum, int beginTrack, int beginOrder,
-									std::vector<std::vector<std::string>> cells)
+									std::vector<std::vector<int>> cells)
 {
 	// Arrange data
-	std::vector<std::vector<std::string>> d;
+	std::vector<std::vector<int>> d;
 	size_t w = songStyle_.trackAttribs.size() - beginTrack;
 	size_t h = getOrderSize(songNum) - beginOrder;
 
@@ -2426,10 +2553,7 @@ void BambooTracker::pasteOrderCells(int songNum, int beginTrack, int beginOrder,
 	size_t height = std::min(cells.size(), h);
 
 	for (size_t i = 0; i < height; ++i) {
-		d.emplace_back();
-		for (size_t j = 0; j < width; ++j) {
-			d.at(i).push_back(cells.at(i).at(j));
-		}
+		d.emplace_back(cells.at(i).begin(), cells.at(i).begin() + static_cast<long>(width));
 	}
 
 	comMan_.invoke(std::make_unique<PasteCopiedDataToOrderCommand>(mod_, songNum, beginTrack, beginOrder, std::move(d)));
@@ -2468,8 +2592,8 @@ bool BambooTracker::canAddNewOrder(int songNum) const
 /*----- Pattern -----*/
 int BambooTracker::getStepNoteNumber(int songNum, int trackNum, int orderNum, int stepNum) const
 {
-	return mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum)
-			.getStep(stepNum).getNoteNumber();
+	const Pattern& ptn = mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum);
+	return ptn.getStep(stepNum).getNoteNumber();
 }
 
 void BambooTracker::setStepNote(int songNum, int trackNum, int orderNum, int stepNum, int octave, Note note)
@@ -2504,8 +2628,8 @@ void BambooTracker::eraseStepNote(int songNum, int trackNum, int orderNum, int s
 
 int BambooTracker::getStepInstrument(int songNum, int trackNum, int orderNum, int stepNum) const
 {
-	return mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum)
-			.getStep(stepNum).getInstrumentNumber();
+	const Pattern& ptn = mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum);
+	return ptn.getStep(stepNum).getInstrumentNumber();
 }
 
 void BambooTracker::setStepInstrument(int songNum, int trackNum, int orderNum, int stepNum, int instNum)
@@ -2520,8 +2644,8 @@ void BambooTracker::eraseStepInstrument(int songNum, int trackNum, int orderNum,
 
 int BambooTracker::getStepVolume(int songNum, int trackNum, int orderNum, int stepNum) const
 {
-	return mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum)
-			.getStep(stepNum).getVolume();
+	const Pattern& ptn = mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum);
+	return ptn.getStep(stepNum).getVolume();
 }
 
 void BambooTracker::setStepVolume(int songNum, int trackNum, int orderNum, int stepNum, int volume, bool isFMReversed)
@@ -2536,8 +2660,8 @@ void BambooTracker::eraseStepVolume(int songNum, int trackNum, int orderNum, int
 
 std::string BambooTracker::getStepEffectID(int songNum, int trackNum, int orderNum, int stepNum, int n) const
 {
-	return mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum)
-			.getStep(stepNum).getEffectID(n);
+	const Pattern& ptn = mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum);
+	return ptn.getStep(stepNum).getEffectID(n);
 }
 
 void BambooTracker::setStepEffectID(int songNum, int trackNum, int orderNum, int stepNum, int n, std::string id)
@@ -2547,8 +2671,8 @@ void BambooTracker::setStepEffectID(int songNum, int trackNum, int orderNum, int
 
 int BambooTracker::getStepEffectValue(int songNum, int trackNum, int orderNum, int stepNum, int n) const
 {
-	return mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum)
-			.getStep(stepNum).getEffectValue(n);
+	const Pattern& ptn = mod_->getSong(songNum).getTrack(trackNum).getPatternFromOrderNumber(orderNum);
+	return ptn.getStep(stepNum).getEffectValue(n);
 }
 
 void BambooTracker::setStepEffectValue(int songNum, int trackNum, int orderNum, int stepNum, int n, int value)
@@ -2577,53 +2701,45 @@ void BambooTracker::deletePreviousStep(int songNum, int trackNum, int orderNum,
 }
 
 void BambooTracker::pastePatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
-									  std::vector<std::vector<std::string>> cells)
+									  PatternCells cells)
 {
-	std::vector<std::vector<std::string>> d
-			= arrangePatternDataCells(songNum, beginTrack, beginColmn, beginOrder, beginStep, std::move(cells));
+	PatternCells d = arrangePatternDataCells(songNum, beginTrack, beginColmn, beginOrder, beginStep, cells);
 
 	comMan_.invoke(std::make_unique<PasteCopiedDataToPatternCommand>(
 					   mod_, songNum, beginTrack, beginColmn, beginOrder, beginStep, std::move(d)));
 }
 
 void BambooTracker::pasteMixPatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
-										 std::vector<std::vector<std::string>> cells)
+										 PatternCells cells)
 {
-	std::vector<std::vector<std::string>> d
-			= arrangePatternDataCells(songNum, beginTrack, beginColmn, beginOrder, beginStep, std::move(cells));
+	PatternCells d = arrangePatternDataCells(songNum, beginTrack, beginColmn, beginOrder, beginStep, cells);
 
 	comMan_.invoke(std::make_unique<PasteMixCopiedDataToPatternCommand>(
 					   mod_, songNum, beginTrack, beginColmn, beginOrder, beginStep, std::move(d)));
 }
 
 void BambooTracker::pasteOverwritePatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder,
-											   int beginStep, std::vector<std::vector<std::string>> cells)
+											   int beginStep, PatternCells cells)
 {
-	std::vector<std::vector<std::string>> d
-			= arrangePatternDataCells(songNum, beginTrack, beginColmn, beginOrder, beginStep, std::move(cells));
+	PatternCells d = arrangePatternDataCells(songNum, beginTrack, beginColmn, beginOrder, beginStep, cells);
 
 	comMan_.invoke(std::make_unique<PasteOverwriteCopiedDataToPatternCommand>(
 					   mod_, songNum, beginTrack, beginColmn, beginOrder, beginStep, std::move(d)));
 }
 
-std::vector<std::vector<std::string>> BambooTracker::arrangePatternDataCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
-																			 std::vector<std::vector<std::string>> cells)
+PatternCells BambooTracker::arrangePatternDataCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
+													const PatternCells& cells)
 {
-	std::vector<std::vector<std::string>> d;
 	size_t w = (songStyle_.trackAttribs.size() - beginTrack - 1) * 11 + (11 - beginColmn);
 	size_t h = getPatternSizeFromOrderNumber(songNum, beginOrder) - beginStep;
 
-	size_t width = std::min(cells.at(0).size(), w);
-	size_t height = std::min(cells.size(), h);
-
-	for (size_t i = 0; i < height; ++i) {
-		d.emplace_back();
-		for (size_t j = 0; j < width; ++j) {
-			d.at(i).push_back(cells.at(i).at(j));
-		}
-	}
+	return cells.cropped(std::min(cells.getRowCount(), h), std::min(cells.getColumnCount(), w));
+}
 
-	return d;
+PatternCells BambooTracker::getPatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
+											size_t rows, size_t columns)
+{
+	return PatternCells(mod_->getSong(songNum), beginOrder, beginTrack, beginColmn, beginStep, rows, columns);
 }
 
 void BambooTracker::erasePatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
@@ -2709,9 +2825,32 @@ size_t BambooTracker::getPatternSizeFromOrderNumber(int songNum, int orderNum) c
 	return size;
 }
 
+size_t BambooTracker::getAbsoluteStepNumber(int songNum, int orderNum, int stepNum) const
+{
+	return getStepTimeline(songNum)->getAbsoluteStep(orderNum, stepNum);
+}
+
+std::pair<int, int> BambooTracker::getPositionFromAbsoluteStepNumber(int songNum, size_t absStep) const
+{
+	return getStepTimeline(songNum)->getPosition(absStep);
+}
+
+std::shared_ptr<const StepTimeline> BambooTracker::getStepTimeline(int songNum) const
+{
+	if (timelineChangeCnt_ != comMan_.getChangeCount()) {
+		timelines_.clear();
+		timelineChangeCnt_ = comMan_.getChangeCount();
+	}
+
+	std::shared_ptr<const StepTimeline>& timeline = timelines_[songNum];
+	if (!timeline) timeline = std::make_shared<StepTimeline>(mod_->getSong(songNum));
+	return timeline;
+}
+
 void BambooTracker::setDefaultPatternSize(int songNum, size_t size)
 {
 	mod_->getSong(songNum).setDefaultPatternSize(size);
+	timelines_.clear();
 }
 
 size_t BambooTracker::getDefaultPatternSize(int songNum) const
@@ -4,7 +4,11 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <map>
 #include <functional>
+#include <future>
+#include <atomic>
+#include <utility>
 #include "configuration.hpp"
 #include "opna_controller.hpp"
 #include "jam_manager.hpp"
@@ -14,6 +18,8 @@
 #include "tick_counter.hpp"
 #include "module.hpp"
 #include "song.hpp"
+#include "pattern_cells.hpp"
+#include "step_timeline.hpp"
 #include "gd3_tag.hpp"
 #include "s98_tag.hpp"
 #include "chips/scci/scci.h"
@@ -44,12 +50,17 @@ public:
 	// Instrument edit
 	void addInstrument(int num, std::string name);
 	void removeInstrument(int num);
-	std::unique_ptr<AbstractInstrument> getInstrument(int num);
+	std::shared_ptr<const AbstractInstrument> getInstrument(int num);
 	void cloneInstrument(int num, int refNum);
 	void deepCloneInstrument(int num, int refNum);
 	void loadInstrument(std::string path, int instNum);
 	void saveInstrument(std::string path, int instNum);
 	void importInstrument(const AbstractBank &bank, size_t index, int instNum);
+	/// Load instruments into free instrument numbers in order, reusing identical properties.
+	/// instNums receives the numbers of added instruments even if an error is thrown,
+	/// and it is shorter than the requests when free numbers run out
+	void loadInstruments(std::vector<std::string> paths, std::vector<int>& instNums);
+	void importInstruments(const AbstractBank &bank, std::vector<size_t> indices, std::vector<int>& instNums);
 	int findFirstFreeInstrumentNumber() const;
 	void setInstrumentName(int num, std::string name);
 	void clearAllInstrument();
@@ -61,12 +72,12 @@ public:
 	void setEnvelopeFMParameter(int envNum, FMEnvelopeParameter param, int value);
 	void setEnvelopeFMOperatorEnable(int envNum, int opNum, bool enable);
 	void setInstrumentFMEnvelope(int instNum, int envNum);
-	std::vector<int> getEnvelopeFMUsers(int envNum) const;
+	InstrumentUserSet getEnvelopeFMUsers(int envNum) const;
 
 	void setLFOFMParameter(int lfoNum, FMLFOParameter param, int value);
 	void setInstrumentFMLFOEnabled(int instNum, bool enabled);
 	void setInstrumentFMLFO(int instNum, int lfoNum);
-	std::vector<int> getLFOFMUsers(int lfoNum) const;
+	InstrumentUserSet getLFOFMUsers(int lfoNum) const;
 
 	void addOperatorSequenceFMSequenceCommand(FMEnvelopeParameter param, int opSeqNum, int type, int data);
 	void removeOperatorSequenceFMSequenceCommand(FMEnvelopeParameter param, int opSeqNum);
@@ -75,7 +86,7 @@ public:
 	void setOperatorSequenceFMRelease(FMEnvelopeParameter param, int opSeqNum, ReleaseType type, int begin);
 	void setInstrumentFMOperatorSequence(int instNum, FMEnvelopeParameter param, int opSeqNum);
 	void setInstrumentFMOperatorSequenceEnabled(int instNum, FMEnvelopeParameter param, bool enabled);
-	std::vector<int> getOperatorSequenceFMUsers(FMEnvelopeParameter param, int opSeqNum) const;
+	InstrumentUserSet getOperatorSequenceFMUsers(FMEnvelopeParameter param, int opSeqNum) const;
 
 	void setArpeggioFMType(int arpNum, int type);
 	void addArpeggioFMSequenceCommand(int arpNum, int type, int data);
@@ -85,7 +96,7 @@ public:
 	void setArpeggioFMRelease(int arpNum, ReleaseType type, int begin);
 	void setInstrumentFMArpeggio(int instNum, int arpNum);
 	void setInstrumentFMArpeggioEnabled(int instNum, bool enabled);
-	std::vector<int> getArpeggioFMUsers(int arpNum) const;
+	InstrumentUserSet getArpeggioFMUsers(int arpNum) const;
 
 	void setPitchFMType(int ptNum, int type);
 	void addPitchFMSequenceCommand(int ptNum, int type, int data);
@@ -95,7 +106,7 @@ public:
 	void setPitchFMRelease(int ptNum, ReleaseType type, int begin);
 	void setInstrumentFMPitch(int instNum, int ptNum);
 	void setInstrumentFMPitchEnabled(int instNum, bool enabled);
-	std::vector<int> getPitchFMUsers(int ptNum) const;
+	InstrumentUserSet getPitchFMUsers(int ptNum) const;
 
 	void setInstrumentFMEnvelopeResetEnabled(int instNum, bool enabled);
 
@@ -107,7 +118,7 @@ public:
 	void setWaveFormSSGRelease(int wfNum, ReleaseType type, int begin);
 	void setInstrumentSSGWaveForm(int instNum, int wfNum);
 	void setInstrumentSSGWaveFormEnabled(int instNum, bool enabled);
-	std::vector<int> getWaveFormSSGUsers(int wfNum) const;
+	InstrumentUserSet getWaveFormSSGUsers(int wfNum) const;
 
 	void addToneNoiseSSGSequenceCommand(int tnNum, int type, int data);
 	void removeToneNoiseSSGSequenceCommand(int tnNum);
@@ -116,7 +127,7 @@ public:
 	void setToneNoiseSSGRelease(int tnNum, ReleaseType type, int begin);
 	void setInstrumentSSGToneNoise(int instNum, int tnNum);
 	void setInstrumentSSGToneNoiseEnabled(int instNum, bool enabled);
-	std::vector<int> getToneNoiseSSGUsers(int tnNum) const;
+	InstrumentUserSet getToneNoiseSSGUsers(int tnNum) const;
 
 	void addEnvelopeSSGSequenceCommand(int envNum, int type, int data);
 	void removeEnvelopeSSGSequenceCommand(int envNum);
@@ -125,7 +136,7 @@ public:
 	void setEnvelopeSSGRelease(int envNum, ReleaseType type, int begin);
 	void setInstrumentSSGEnvelope(int instNum, int envNum);
 	void setInstrumentSSGEnvelopeEnabled(int instNum, bool enabled);
-	std::vector<int> getEnvelopeSSGUsers(int envNum) const;
+	InstrumentUserSet getEnvelopeSSGUsers(int envNum) const;
 
 	void setArpeggioSSGType(int arpNum, int type);
 	void addArpeggioSSGSequenceCommand(int arpNum, int type, int data);
@@ -135,7 +146,7 @@ public:
 	void setArpeggioSSGRelease(int arpNum, ReleaseType type, int begin);
 	void setInstrumentSSGArpeggio(int instNum, int arpNum);
 	void setInstrumentSSGArpeggioEnabled(int instNum, bool enabled);
-	std::vector<int> getArpeggioSSGUsers(int arpNum) const;
+	InstrumentUserSet getArpeggioSSGUsers(int arpNum) const;
 
 	void setPitchSSGType(int ptNum, int type);
 	void addPitchSSGSequenceCommand(int ptNum, int type, int data);
@@ -145,7 +156,7 @@ public:
 	void setPitchSSGRelease(int ptNum, ReleaseType type, int begin);
 	void setInstrumentSSGPitch(int instNum, int ptNum);
 	void setInstrumentSSGPitchEnabled(int instNum, bool enabled);
-	std::vector<int> getPitchSSGUsers(int ptNum) const;
+	InstrumentUserSet getPitchSSGUsers(int ptNum) const;
 
 	// Song edit
 	void setCurrentSongNumber(int num);
@@ -162,6 +173,7 @@ public:
 	// Undo-Redo
 	void undo();
 	void redo();
+	bool canUndo() const;
 	void clearCommandHistory();
 
 	// Jam mode
@@ -216,7 +228,17 @@ public:
 	/*----- Module -----*/
 	void makeNewModule();
 	void loadModule(std::string path);
-	void saveModule(std::string path);
+	/// Load module to new module data in a worker thread.
+	/// The current module is kept until finishLoadingModule is called
+	void startLoadingModule(std::string path);
+	bool isLoadingModule() const;
+	/// Return loaded percentage
+	int getModuleLoadingProgress() const;
+	void cancelLoadingModule();
+	/// Wait for the worker and swap the loaded module in.
+	/// Return false if loading is canceled, and rethrow the error of loading
+	bool finishLoadingModule();
+	void saveModule(std::string path, bool isCompressed = false);
 	void setModulePath(std::string path);
 	std::string getModulePath() const;
 	void setModuleTitle(std::string title);
@@ -258,7 +280,7 @@ public:
 	void insertOrderBelow(int songNum, int orderNum);
 	void deleteOrder(int songNum, int orderNum);
 	void pasteOrderCells(int songNum, int beginTrack, int beginOrder,
-						   std::vector<std::vector<std::string>> cells);
+						   std::vector<std::vector<int>> cells);
 	void duplicateOrder(int songNum, int orderNum);
 	void MoveOrder(int songNum, int orderNum, bool isUp);
 	void clonePatterns(int songNum, int beginOrder, int beginTrack, int endOrder, int endTrack);
@@ -292,13 +314,16 @@ public:
 	///		3: effect id
 	///		4: effect value
 	void pastePatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
-						   std::vector<std::vector<std::string>> cells);
+						   PatternCells cells);
 	void pasteMixPatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
-							  std::vector<std::vector<std::string>> cells);
+							  PatternCells cells);
 	void pasteOverwritePatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder,
-									int beginStep, std::vector<std::vector<std::string>> cells);
-	std::vector<std::vector<std::string>> arrangePatternDataCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
-																  std::vector<std::vector<std::string>> cells);
+									int beginStep, PatternCells cells);
+	PatternCells arrangePatternDataCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
+										 const PatternCells& cells);
+	/// Copy a rectangular range of cells beginning at the given position
+	PatternCells getPatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
+								 size_t rows, size_t columns);
 	void erasePatternCells(int songNum, int beginTrack, int beginColmn, int beginOrder, int beginStep,
 						   int endTrack, int endColmn, int endStep);
 	void increaseNoteKeyInPattern(int songNum, int beginTrack, int beginOrder, int beginStep,
@@ -320,10 +345,17 @@ public:
 	void replaceInstrumentInPattern(int songNum, int beginTrack, int beginOrder, int beginStep,
 									int endTrack, int endStep, int newInstNum);
 	size_t getPatternSizeFromOrderNumber(int songNum, int orderNum) const;
+	/// Step number counted from the first step of the song
+	size_t getAbsoluteStepNumber(int songNum, int orderNum, int stepNum) const;
+	/// Order and step numbers of the step counted from the first step of the song
+	std::pair<int, int> getPositionFromAbsoluteStepNumber(int songNum, size_t absStep) const;
 	void setDefaultPatternSize(int songNum, size_t size);
 	size_t getDefaultPatternSize(int songNum) const;
 
 private:
+	void addInstruments(size_t count, std::function<AbstractInstrument*(size_t, int)> load,
+						std::vector<int>& instNums);
+
 	CommandManager comMan_;
 	std::shared_ptr<InstrumentsManager> instMan_;
 	std::unique_ptr<JamManager> jamMan_;
@@ -333,6 +365,18 @@ private:
 
 	std::shared_ptr<Module> mod_;
 
+	// Step positions of each song, dropped when the module is edited.
+	// A returned timeline stays valid while it is held even if the cache is rebuilt
+	mutable std::map<int, std::shared_ptr<const StepTimeline>> timelines_;
+	mutable size_t timelineChangeCnt_;
+	std::shared_ptr<const StepTimeline> getStepTimeline(int songNum) const;
+
+	std::atomic_bool isModLoadCanceled_;
+	std::atomic_int modLoadProgress_;
+	std::shared_ptr<Module> loadingMod_;
+	std::shared_ptr<InstrumentsManager> loadingInstMan_;
+	std::future<bool> modLoader_;	// Destructed first to wait for the worker
+
 	// Current status
 	int octave_;	// 0-7
 	int curSongNum_;
@@ -364,14 +408,14 @@ private:
 	void readStep();
 	void readTick(int rest);
 
-	void readTickFMForNoteDelay(Step& step, int ch);
-	void envelopeResetEffectFM(Step& step, int ch);
+	void readTickFMForNoteDelay(const Step& step, int ch);
+	void envelopeResetEffectFM(const Step& step, int ch);
 
 	void clearDelayCounts();
 
-	bool readFMStep(Step& step, int ch, bool isSkippedSpecial = false);
-	bool readSSGStep(Step& step, int ch, bool isSkippedSpecial = false);
-	bool readDrumStep(Step& step, int ch, bool isSkippedSpecial = false);
+	bool readFMStep(const Step& step, int ch, bool isSkippedSpecial = false);
+	bool readSSGStep(const Step& step, int ch, bool isSkippedSpecial = false);
+	bool readDrumStep(const Step& step, int ch, bool isSkippedSpecial = false);
 
 	bool readFMEffect(int ch, std::string id, int value, bool isSkippedSpecial = false);
 	bool readSSGEffect(int ch, std::string id, int value, bool isSkippedSpecial = false);
@@ -393,7 +437,7 @@ private:
 	std::vector<int> tposeDlyCntFM_, tposeDlyCntSSG_;
 	std::vector<int> tposeDlyValueFM_, tposeDlyValueSSG_;
 
-	void checkNextPositionOfLastStep(int& endOrder, int& endStep) const;
+	void checkNextPositionOfLastStep(int songNum, int& endOrder, int& endStep) const;
 
 	bool isRetrieveChannel_;
 	void retrieveChannelStates();
@@ -20,13 +20,14 @@
 #include "2608intf.h"
 //#include "fm.h"
 
-// Only use EC_EMU2149
+// Only use EC_EMU2149 and EC_BLEP2149
 //#define ENABLE_ALL_CORES
 
 #ifdef ENABLE_ALL_CORES
 #define EC_MAME		0x01	// AY8910 core from MAME
 #endif
 #define EC_EMU2149	0x00
+#define EC_BLEP2149	0x02	// Band-limited core rendering at the output rate
 
 typedef struct _ym2608_state ym2608_state;
 struct _ym2608_state
@@ -76,6 +77,9 @@ static void psg_set_clock(void *param, int clock)
 		case EC_EMU2149:
 			PSG_set_clock((PSG*)info->psg, clock);
 			break;
+		case EC_BLEP2149:
+			BPSG_set_clock((BPSG*)info->psg, clock);
+			break;
 		}
 	}
 }
@@ -95,6 +99,9 @@ static void psg_write(void *param, int address, int data)
 		case EC_EMU2149:
 			PSG_writeIO((PSG*)info->psg, address, data);
 			break;
+		case EC_BLEP2149:
+			BPSG_writeIO((BPSG*)info->psg, address, data);
+			break;
 		}
 	}
 }
@@ -112,6 +119,8 @@ static int psg_read(void *param)
 #endif
 		case EC_EMU2149:
 			return PSG_readIO((PSG*)info->psg);
+		case EC_BLEP2149:
+			return BPSG_readIO((BPSG*)info->psg);
 		}
 	}
 	return 0x00;
@@ -132,6 +141,9 @@ static void psg_reset(void *param)
 		case EC_EMU2149:
 			PSG_reset((PSG*)info->psg);
 			break;
+		case EC_BLEP2149:
+			BPSG_reset((BPSG*)info->psg);
+			break;
 		}
 	}
 }
@@ -218,6 +230,9 @@ void ym2608_stream_update_ay(UINT8 ChipID, stream_sample_t **outputs, int sample
 		case EC_EMU2149:
 			PSG_calc_stereo((PSG*)info->psg, outputs, samples);
 			break;
+		case EC_BLEP2149:
+			BPSG_calc_stereo((BPSG*)info->psg, outputs, samples);
+			break;
 		}
 	}
 	else
@@ -293,6 +308,12 @@ int device_start_ym2608(UINT8 ChipID, int clock, UINT8 AYDisable, UINT8 AYFlags,
 				return 0;
 			PSG_setVolumeMode((PSG*)info->psg, 1);	// YM2149 volume mode
 			break;
+		case EC_BLEP2149:
+			*AYrate = CHIP_SAMPLE_RATE;	// Rendered at the output rate
+			info->psg = BPSG_new(ay_clock, *AYrate);
+			if (info->psg == NULL)
+				return 0;
+			break;
 		}
 	}
 	else
@@ -342,6 +363,9 @@ void device_stop_ym2608(UINT8 ChipID)
 		case EC_EMU2149:
 			PSG_delete((PSG*)info->psg);
 			break;
+		case EC_BLEP2149:
+			BPSG_delete((BPSG*)info->psg);
+			break;
 		}
 		info->psg = NULL;
 	}
@@ -414,14 +438,41 @@ void ym2608_data_port_b_w(UINT8 ChipID, offs_t offset, UINT8 data)
 void ym2608_set_ay_emu_core(UINT8 Emulator)
 {
 #ifdef ENABLE_ALL_CORES
-	AY_EMU_CORE = (Emulator < 0x02) ? Emulator : 0x00;
+	AY_EMU_CORE = (Emulator < 0x03) ? Emulator : 0x00;
 #else
-	AY_EMU_CORE = EC_EMU2149;
+	AY_EMU_CORE = (Emulator == EC_BLEP2149) ? EC_BLEP2149 : EC_EMU2149;
 #endif
 	
 	return;
 }
 
+int ym2608_set_ay_rate(UINT8 ChipID, int rate)
+{
+	ym2608_state *info = &YM2608Data[ChipID];
+	if (info->psg != NULL)
+	{
+		switch(AY_EMU_CORE)
+		{
+#ifdef ENABLE_ALL_CORES
+		case EC_MAME:
+			break;
+#endif
+		case EC_EMU2149:
+			return ((PSG*)info->psg)->rate;	// Fixed to the internal rate
+		case EC_BLEP2149:
+			BPSG_set_rate((BPSG*)info->psg, rate);
+			return rate;
+		}
+	}
+	return 0;
+}
+
+void ym2608_set_fm_rate(UINT8 ChipID, int rate)
+{
+	ym2608_state *info = &YM2608Data[ChipID];
+	ym2608_set_rate(info->chip, rate);
+}
+
 //void ym2608_write_data_pcmrom(UINT8 ChipID, UINT8 rom_id, offs_t ROMSize, offs_t DataStart,
 //							  offs_t DataLength, const UINT8* ROMData)
 //{
@@ -445,6 +496,9 @@ void ym2608_set_mute_mask(UINT8 ChipID, UINT32 MuteMaskFM, UINT32 MuteMaskAY)
 		case EC_EMU2149:
 			PSG_setMask((PSG*)info->psg, MuteMaskAY);
 			break;
+		case EC_BLEP2149:
+			BPSG_setMask((BPSG*)info->psg, MuteMaskAY);
+			break;
 		}
 	}
 }
@@ -3,6 +3,7 @@
 #include "mamedef.h"
 #include "fm.h"
 #include "emu2149.h"
+#include "blep2149.h"
 
 #ifdef INCLUDE_AY8910_H
 #include "ay8910.h"
@@ -86,6 +87,8 @@ void ym2608_data_port_a_w(UINT8 ChipID, offs_t offset, UINT8 data);
 void ym2608_data_port_b_w(UINT8 ChipID, offs_t offset, UINT8 data);
 
 void ym2608_set_ay_emu_core(UINT8 Emulator);
+int ym2608_set_ay_rate(UINT8 ChipID, int rate);
+void ym2608_set_fm_rate(UINT8 ChipID, int rate);
 //void ym2608_write_data_pcmrom(UINT8 ChipID, UINT8 rom_id, offs_t ROMSize, offs_t DataStart,
 //							  offs_t DataLength, const UINT8* ROMData);
 void ym2608_set_mute_mask(UINT8 ChipID, UINT32 MuteMaskFM, UINT32 MuteMaskAY);
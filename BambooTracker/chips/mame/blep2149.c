@@ -0,0 +1,465 @@
+/****************************************************************************
+
+  blep2149.c -- Band-limited YM2149 emulator
+
+  Generator behaviour follows emu2149.c (YM2149 volume table, single output),
+  but instead of stepping every generator at clock / 8 and resampling the
+  result, the tone, noise and envelope units are advanced from one event to
+  the next and every change of the output level is written to the output
+  buffer as a band-limited step (BLEP). The chip is rendered directly at the
+  output rate.
+
+*****************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "blep2149.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static e_uint32 voltbl[32] = {
+  0x00, 0x01, 0x01, 0x02, 0x02, 0x03, 0x03, 0x04, 0x05, 0x06, 0x07, 0x09,
+  0x0B, 0x0D, 0x0F, 0x12,
+  0x16, 0x1A, 0x1F, 0x25, 0x2D, 0x35, 0x3F, 0x4C, 0x5A, 0x6A, 0x7F, 0x97,
+  0xB4, 0xD6, 0xEB, 0xFF
+};
+
+#define BLEP_PHASE_BITS 5
+#define BLEP_UNIT_BITS 15
+/* Kernel sums to 1 << BLEP_UNIT_BITS, output is scaled like emu2149 (<< 5) */
+#define BLEP_OUT_SHIFT (BLEP_UNIT_BITS - 5)
+/* Cutoff frequency of the kernel relative to the output rate */
+#define BLEP_CUTOFF 0.45
+
+static e_int32 blep_kernel[BPSG_BLEP_PHASES][BPSG_BLEP_TAPS];
+static int blep_kernel_ready = 0;
+
+static void
+make_kernel (void)
+{
+  int p, i, peak;
+  double x, h, w, sum, v[BPSG_BLEP_TAPS];
+  e_int32 total;
+
+  if (blep_kernel_ready)
+    return;
+
+  for (p = 0; p < BPSG_BLEP_PHASES; p++)
+  {
+    /* Windowed sinc centered between the middle taps */
+    sum = 0;
+    for (i = 0; i < BPSG_BLEP_TAPS; i++)
+    {
+      x = i - (double) p / BPSG_BLEP_PHASES - (BPSG_BLEP_TAPS - 1) / 2.0;
+      if (fabs (x) >= BPSG_BLEP_TAPS / 2)
+      {
+        v[i] = 0;
+        continue;
+      }
+      h = (x == 0) ? 1.0 : sin (2 * M_PI * BLEP_CUTOFF * x) / (2 * M_PI * BLEP_CUTOFF * x);
+      w = 0.42 + 0.5 * cos (2 * M_PI * x / BPSG_BLEP_TAPS)
+          + 0.08 * cos (4 * M_PI * x / BPSG_BLEP_TAPS);
+      v[i] = h * w;
+      sum += v[i];
+    }
+
+    /* Normalize so that each step settles exactly on its new level */
+    total = 0;
+    peak = 0;
+    for (i = 0; i < BPSG_BLEP_TAPS; i++)
+    {
+      blep_kernel[p][i] = (e_int32) floor (v[i] * (1 << BLEP_UNIT_BITS) / sum + 0.5);
+      total += blep_kernel[p][i];
+      if (blep_kernel[p][i] > blep_kernel[p][peak])
+        peak = i;
+    }
+    blep_kernel[p][peak] += (1 << BLEP_UNIT_BITS) - total;
+  }
+
+  blep_kernel_ready = 1;
+}
+
+static void
+internal_refresh (BPSG * psg)
+{
+  psg->factor = ((e_uint64) psg->rate << 32) / (psg->clk / 8);
+}
+
+BLEP2149_API void
+BPSG_set_clock (BPSG * psg, e_uint32 c)
+{
+  psg->clk = c;
+  internal_refresh (psg);
+}
+
+BLEP2149_API void
+BPSG_set_rate (BPSG * psg, e_uint32 r)
+{
+  psg->rate = r ? r : 44100;
+  internal_refresh (psg);
+}
+
+BLEP2149_API BPSG *
+BPSG_new (e_uint32 c, e_uint32 r)
+{
+  BPSG *psg;
+
+  make_kernel ();
+
+  psg = (BPSG *) malloc (sizeof (BPSG));
+  if (psg == NULL)
+    return NULL;
+  memset (psg, 0x00, sizeof (BPSG));
+
+  psg->clk = c;
+  psg->rate = r ? r : 44100;
+  internal_refresh (psg);
+
+  return psg;
+}
+
+BLEP2149_API e_uint32
+BPSG_setMask (BPSG * psg, e_uint32 mask)
+{
+  e_uint32 ret = 0;
+  if (psg)
+  {
+    ret = psg->mask;
+    psg->mask = mask;
+    BPSG_writeReg (psg, 7, psg->reg[7]);	/* Refresh the output level */
+  }
+  return ret;
+}
+
+BLEP2149_API void
+BPSG_reset (BPSG * psg)
+{
+  int i;
+
+  for (i = 0; i < 3; i++)
+  {
+    psg->count[i] = 0;
+    psg->freq[i] = 0;
+    psg->edge[i] = 1;	/* Fixed while the period is 0 or 1 */
+    psg->volume[i] = 0;
+    psg->tmask[i] = 0;
+    psg->nmask[i] = 0;
+  }
+
+  psg->mask = 0;
+
+  for (i = 0; i < 16; i++)
+    psg->reg[i] = 0;
+  psg->adr = 0;
+
+  psg->noise_seed = 0xffff;
+  psg->noise_count = 0;
+  psg->noise_freq = 1;
+  psg->noise_used = 0;
+
+  psg->env_ptr = 0;
+  psg->env_freq = 0;
+  psg->env_count = 0;
+  psg->env_pause = 1;
+
+  psg->offset = 0;
+  psg->amp = 0;
+  psg->integ = 0;
+  memset (psg->buf, 0x00, sizeof (psg->buf));
+}
+
+BLEP2149_API void
+BPSG_delete (BPSG * psg)
+{
+  free (psg);
+}
+
+BLEP2149_API e_uint8
+BPSG_readIO (BPSG * psg)
+{
+  return (e_uint8) (psg->reg[psg->adr]);
+}
+
+BLEP2149_API e_uint8
+BPSG_readReg (BPSG * psg, e_uint32 reg)
+{
+  return (e_uint8) (psg->reg[reg & 0x1f]);
+}
+
+BLEP2149_API void
+BPSG_writeIO (BPSG * psg, e_uint32 adr, e_uint32 val)
+{
+  if (adr & 1)
+    BPSG_writeReg (psg, psg->adr, val);
+  else
+    psg->adr = val & 0x1f;
+}
+
+INLINE static e_int32
+calc_amp (BPSG * psg)
+{
+  int i;
+  e_uint32 noise = psg->noise_seed & 1;
+  e_int32 amp = 0;
+
+  for (i = 0; i < 3; i++)
+  {
+    if (psg->mask & BPSG_MASK_CH (i))
+      continue;
+
+    if ((psg->tmask[i] || psg->edge[i]) && (psg->nmask[i] || noise))
+    {
+      if (!(psg->volume[i] & 32))
+        amp += voltbl[psg->volume[i] & 31];
+      else
+        amp += voltbl[psg->env_ptr];
+    }
+  }
+
+  return amp;
+}
+
+/* Put the change of the output level at pos (32.32 fixed point) */
+INLINE static void
+update_amp (BPSG * psg, e_uint64 pos)
+{
+  int i;
+  e_int32 amp = calc_amp (psg);
+  e_int32 delta = amp - psg->amp;
+  const e_int32 *kernel;
+  e_int32 *buf;
+
+  if (!delta)
+    return;
+  psg->amp = amp;
+
+  kernel = blep_kernel[(pos >> (32 - BLEP_PHASE_BITS)) & (BPSG_BLEP_PHASES - 1)];
+  buf = psg->buf + (e_uint32) (pos >> 32);
+  for (i = 0; i < BPSG_BLEP_TAPS; i++)
+    buf[i] += kernel[i] * delta;
+}
+
+INLINE static void
+step_env (BPSG * psg)
+{
+  if (psg->env_face)
+    psg->env_ptr = (psg->env_ptr + 1) & 0x3f;
+  else
+    psg->env_ptr = (psg->env_ptr + 0x3f) & 0x3f;
+
+  if (psg->env_ptr & 0x20) /* if carry or borrow */
+  {
+    if (psg->env_continue)
+    {
+      if (psg->env_alternate^psg->env_hold) psg->env_face ^= 1;
+      if (psg->env_hold) psg->env_pause = 1;
+      psg->env_ptr = psg->env_face?0:0x1f;
+    }
+    else
+    {
+      psg->env_pause = 1;
+      psg->env_ptr = 0;
+    }
+  }
+}
+
+/* Run the generators over one frame of at most BPSG_BUF_LEN samples */
+static void
+calc_frame (BPSG * psg, e_int32 samples)
+{
+  int i;
+  e_uint64 limit = (e_uint64) samples << 32;
+  e_uint32 ticks, t, step;
+  int env_on;
+
+  ticks = (psg->offset < limit)
+          ? (e_uint32) ((limit - psg->offset + psg->factor - 1) / psg->factor) : 0;
+
+  for (t = 0;;)
+  {
+    /* Find the next tick in which any generator steps */
+    step = ticks - t;
+    for (i = 0; i < 3; i++)
+    {
+      if (psg->freq[i] > 1 && psg->count[i] < step)
+        step = psg->count[i];
+    }
+    if (psg->noise_used && psg->noise_count < step)
+      step = psg->noise_count;
+    env_on = !psg->env_pause && psg->env_freq;
+    if (env_on && psg->env_count < step)
+      step = psg->env_count;
+
+    if (step == ticks - t)
+      break;
+
+    t += step;
+
+    /* Envelope */
+    if (env_on)
+    {
+      psg->env_count -= step;
+      if (!psg->env_count)
+      {
+        step_env (psg);
+        psg->env_count = psg->env_freq;
+      }
+    }
+
+    /* Noise */
+    if (psg->noise_used)
+    {
+      psg->noise_count -= step;
+      if (!psg->noise_count)
+      {
+        if (psg->noise_seed & 1)
+          psg->noise_seed ^= 0x24000;
+        psg->noise_seed >>= 1;
+        psg->noise_count = psg->noise_freq;
+      }
+    }
+
+    /* Tone */
+    for (i = 0; i < 3; i++)
+    {
+      if (psg->freq[i] > 1)
+      {
+        psg->count[i] -= step;
+        if (!psg->count[i])
+        {
+          psg->edge[i] = !psg->edge[i];
+          psg->count[i] = psg->freq[i];
+        }
+      }
+    }
+
+    update_amp (psg, psg->offset + t * psg->factor);
+  }
+
+  /* Carry the rest of the ticks over to the next frame */
+  step = ticks - t;
+  if (!psg->env_pause && psg->env_freq)
+    psg->env_count -= step;
+  if (psg->noise_used)
+    psg->noise_count -= step;
+  for (i = 0; i < 3; i++)
+  {
+    if (psg->freq[i] > 1)
+      psg->count[i] -= step;
+  }
+
+  psg->offset = psg->offset + ticks * psg->factor - limit;
+}
+
+BLEP2149_API void
+BPSG_calc_stereo (BPSG * psg, e_int32 **out, e_int32 samples)
+{
+  e_int32 *bufMO = out[0];
+  e_int32 *bufRO = out[1];
+  e_int32 n;
+
+  int i;
+
+  while (samples > 0)
+  {
+    n = (samples < BPSG_BUF_LEN) ? samples : BPSG_BUF_LEN;
+
+    calc_frame (psg, n);
+
+    for (i = 0; i < n; i++)
+    {
+      psg->integ += psg->buf[i];
+      bufMO[i] = bufRO[i] = psg->integ >> BLEP_OUT_SHIFT;
+    }
+
+    /* Move the kernel tail to the head of the buffer */
+    memmove (psg->buf, psg->buf + n, BPSG_BLEP_TAPS * sizeof (e_int32));
+    memset (psg->buf + BPSG_BLEP_TAPS, 0x00, n * sizeof (e_int32));
+
+    bufMO += n;
+    bufRO += n;
+    samples -= n;
+  }
+}
+
+BLEP2149_API void
+BPSG_writeReg (BPSG * psg, e_uint32 reg, e_uint32 val)
+{
+  int c;
+
+  if (reg > 15) return;
+
+  psg->reg[reg] = (e_uint8) (val & 0xff);
+  switch (reg)
+  {
+  case 0:
+  case 2:
+  case 4:
+  case 1:
+  case 3:
+  case 5:
+    c = reg >> 1;
+    if (psg->freq[c] <= 1)
+      psg->count[c] = 0;	/* Step in the next tick */
+    psg->freq[c] = ((psg->reg[c * 2 + 1] & 15) << 8) + psg->reg[c * 2];
+    if (psg->freq[c] <= 1)
+      psg->edge[c] = 1;
+    break;
+
+  case 6:
+    psg->noise_freq = (val == 0) ? 1 : ((val & 31) << 1);
+    if (psg->noise_count > psg->noise_freq)
+      psg->noise_count = psg->noise_freq;
+    break;
+
+  case 7:
+    psg->tmask[0] = (val & 1);
+    psg->tmask[1] = (val & 2);
+    psg->tmask[2] = (val & 4);
+    psg->nmask[0] = (val & 8);
+    psg->nmask[1] = (val & 16);
+    psg->nmask[2] = (val & 32);
+    break;
+
+  case 8:
+  case 9:
+  case 10:
+    psg->volume[reg - 8] = val << 1;
+    break;
+
+  case 11:
+  case 12:
+    psg->env_freq = (psg->reg[12] << 8) + psg->reg[11];
+    if (psg->env_count > psg->env_freq)
+      psg->env_count = psg->env_freq;
+    break;
+
+  case 13:
+    psg->env_continue = (val >> 3) & 1;
+    psg->env_attack = (val >> 2) & 1;
+    psg->env_alternate = (val >> 1) & 1;
+    psg->env_hold = val & 1;
+    psg->env_face = psg->env_attack;
+    psg->env_pause = 0;
+    psg->env_count = psg->env_freq ? psg->env_freq - 1 : 0;
+    psg->env_ptr = psg->env_face?0:0x1f;
+    break;
+
+  case 14:
+  case 15:
+  default:
+    return;
+  }
+
+  /* The noise generator is only run while it can be heard */
+  psg->noise_used = 0;
+  for (c = 0; c < 3; c++)
+  {
+    if (!(psg->mask & BPSG_MASK_CH (c)) && !psg->nmask[c] && psg->volume[c])
+      psg->noise_used = 1;
+  }
+
+  update_amp (psg, psg->offset);
+}
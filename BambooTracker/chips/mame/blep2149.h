@@ -0,0 +1,80 @@
+/* blep2149.h */
+#ifndef _BLEP2149_H_
+#define _BLEP2149_H_
+#include "emutypes.h"
+
+#define BLEP2149_API
+
+#define BPSG_MASK_CH(x) (1<<(x))
+
+/* Band-limited step kernel */
+#define BPSG_BLEP_PHASES 32
+#define BPSG_BLEP_TAPS 16
+
+/* Maximum number of samples rendered per pass */
+#define BPSG_BUF_LEN 4096
+
+  typedef struct __BPSG
+  {
+
+    e_uint8 reg[0x20];
+
+    e_uint32 clk, rate;
+
+    /* Output rate per generator tick (32.32 fixed point) */
+    e_uint64 factor;
+    /* Position of the next tick in the next frame (32.32 fixed point) */
+    e_uint64 offset;
+
+    /* Ticks left until each generator steps */
+    e_uint32 count[3];
+    e_uint32 volume[3];
+    e_uint32 freq[3];
+    e_uint32 edge[3];
+    e_uint32 tmask[3];
+    e_uint32 nmask[3];
+    e_uint32 mask;
+
+    e_uint32 env_ptr;
+    e_uint32 env_face;
+
+    e_uint32 env_continue;
+    e_uint32 env_attack;
+    e_uint32 env_alternate;
+    e_uint32 env_hold;
+    e_uint32 env_pause;
+
+    e_uint32 env_freq;
+    e_uint32 env_count;
+
+    e_uint32 noise_seed;
+    e_uint32 noise_count;
+    e_uint32 noise_freq;
+    e_uint32 noise_used;
+
+    /* Current output level and integrator */
+    e_int32 amp;
+    e_int32 integ;
+
+    /* Pending deltas, BPSG_BLEP_TAPS past the end for the kernel tail */
+    e_int32 buf[BPSG_BUF_LEN + BPSG_BLEP_TAPS];
+
+    /* I/O Ctrl */
+    e_uint32 adr;
+
+  }
+  BPSG;
+
+  BLEP2149_API void BPSG_set_clock (BPSG * psg, e_uint32 c);
+  BLEP2149_API void BPSG_set_rate (BPSG * psg, e_uint32 r);
+  BLEP2149_API BPSG *BPSG_new (e_uint32 clk, e_uint32 rate);
+  BLEP2149_API void BPSG_reset (BPSG *);
+  BLEP2149_API void BPSG_delete (BPSG *);
+  BLEP2149_API void BPSG_writeReg (BPSG *, e_uint32 reg, e_uint32 val);
+  BLEP2149_API void BPSG_writeIO (BPSG * psg, e_uint32 adr, e_uint32 val);
+  BLEP2149_API e_uint8 BPSG_readReg (BPSG * psg, e_uint32 reg);
+  BLEP2149_API e_uint8 BPSG_readIO (BPSG * psg);
+  BLEP2149_API void BPSG_calc_stereo (BPSG * psg, e_int32 **out, e_int32 samples);
+  BLEP2149_API e_uint32 BPSG_setMask (BPSG *, e_uint32 mask);
+
+#endif
@@ -28,4 +28,7 @@ typedef signed short e_int16 ;
 typedef unsigned int e_uint32 ;
 typedef signed int e_int32 ;
 
+typedef unsigned long long e_uint64 ;
+typedef signed long long e_int64 ;
+
 #endif
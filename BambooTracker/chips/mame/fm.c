@@ -595,6 +595,7 @@ typedef struct
 	UINT8	kcode;		/* key code:                        */
 	UINT32	block_fnum;	/* current blk/fnum value for this slot (can be different betweeen slots of one channel in 3slot mode) */
 	UINT8	Muted;
+	UINT8	idle;		/* 1=all operators released and no residual output (skip calculation until key-on) */
 } FM_CH;
 
 
@@ -878,6 +879,7 @@ INLINE void FM_KEYON(UINT8 type, FM_CH *CH , int s )
 	FM_SLOT *SLOT = &CH->SLOT[s];
 	if( !SLOT->key )
 	{
+		CH->idle = 0;	/* wake up channel */
 		SLOT->key = 1;
 		SLOT->phase = 0;		/* restart Phase Generator */
 		SLOT->ssgn = (SLOT->ssg & 0x04) >> 1;
@@ -1434,6 +1436,17 @@ INLINE void chan_calc(FM_OPN *OPN, FM_CH *CH, int chnum)
 	}
 }
 
+/* check whether a channel has become silent */
+/* When all operators are in EG_OFF, the outputs stay under ENV_QUIET and the phases are
+   restarted by the next key-on, so the channel can be skipped once its feedback
+   and MEM values have drained to zero. */
+INLINE void update_idle_channel(FM_CH *CH)
+{
+	CH->idle = (CH->SLOT[SLOT1].state == EG_OFF) && (CH->SLOT[SLOT2].state == EG_OFF)
+			&& (CH->SLOT[SLOT3].state == EG_OFF) && (CH->SLOT[SLOT4].state == EG_OFF)
+			&& !CH->op1_out[0] && !CH->op1_out[1] && !CH->mem_value;
+}
+
 /* update phase increment and envelope generator */
 INLINE void refresh_fc_eg_slot(FM_OPN *OPN, FM_SLOT *SLOT , int fc , int kc )
 {
@@ -1533,6 +1546,7 @@ static void reset_channels( FM_ST *ST , FM_CH *CH , int num )
 		CH[c].op1_out[0] = 0;
 		CH[c].op1_out[1] = 0;
 		CH[c].fc = 0;
+		CH[c].idle = 1;
 		for(s = 0 ; s < 4 ; s++ )
 		{
 			//memset(&CH[c].SLOT[s], 0x00, sizeof(FM_SLOT));
@@ -3383,13 +3397,12 @@ void ym2608_update_one(void *chip, FMSAMPLE **buffer, int length)
 		out_fm[4] = 0;
 		out_fm[5] = 0;
 
-		/* calculate FM */
-		chan_calc(OPN, cch[0], 0 );
-		chan_calc(OPN, cch[1], 1 );
-		chan_calc(OPN, cch[2], 2 );
-		chan_calc(OPN, cch[3], 3 );
-		chan_calc(OPN, cch[4], 4 );
-		chan_calc(OPN, cch[5], 5 );
+		/* calculate FM (skip idle channels) */
+		for( j = 0; j < 6; j++ )
+		{
+			if( !cch[j]->idle )
+				chan_calc(OPN, cch[j], j );
+		}
 
 		/* deltaT ADPCM */
 		if( DELTAT->portstate&0x80 && ! F2608->MuteDeltaT )
@@ -3409,12 +3422,14 @@ void ym2608_update_one(void *chip, FMSAMPLE **buffer, int length)
 			OPN->eg_timer -= OPN->eg_timer_overflow;
 			OPN->eg_cnt++;
 
-			advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[3]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[4]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[5]->SLOT[SLOT1]);
+			for( j = 0; j < 6; j++ )
+			{
+				if( !cch[j]->idle )
+				{
+					advance_eg_channel(OPN, &cch[j]->SLOT[SLOT1]);
+					update_idle_channel(cch[j]);
+				}
+			}
 		}
 
 		/* buffering */
@@ -3920,6 +3935,44 @@ void ym2608_write_pcmrom(void *chip, UINT8 rom_id, offs_t ROMSize, offs_t DataSt
 	return;
 }
 
+/* change the synthesis rate without resetting the chip */
+void ym2608_set_rate(void *chip, int rate)
+{
+	YM2608 *F2608 = (YM2608 *)chip;
+	FM_OPN *OPN   = &F2608->OPN;
+	int i;
+
+	OPN->ST.rate = rate;
+	/* rebuild the rate dependent tables with the current prescaler */
+	OPNPrescaler_w(OPN, 1, 2);
+	F2608->deltaT.freqbase = OPN->ST.freqbase;
+
+	/* refresh the increments derived from the latched LFO and DELTA-N registers */
+	OPN->lfo_inc = (F2608->REGS[0x22] & 0x08) ? OPN->lfo_freq[F2608->REGS[0x22] & 7] : 0;
+	F2608->deltaT.step = (UINT32)((double)(F2608->deltaT.delta) * (F2608->deltaT.freqbase));
+
+	/* refresh the phase increments cached from the old fn_table */
+	for (i = 0; i < 6; i++)
+	{
+		FM_CH *CH = &F2608->CH[i];
+		CH->fc = OPN->fn_table[(CH->block_fnum & 0x7ff)*2]>>(7-(CH->block_fnum>>11));
+		CH->SLOT[SLOT1].Incr = -1;
+	}
+	for (i = 0; i < 3; i++)
+	{
+		UINT32 bf = OPN->SL3.block_fnum[i];
+		OPN->SL3.fc[i] = OPN->fn_table[(bf & 0x7ff)*2]>>(7-(bf>>11));
+	}
+
+	for (i = 0; i < 6; i++)
+	{
+		if (i<=3)	/* channels 0,1,2,3 */
+			F2608->adpcm[i].step = (UINT32)((float)(1<<ADPCM_SHIFT)*((float)OPN->ST.freqbase)/3.0);
+		else		/* channels 4 and 5 work with slower clock */
+			F2608->adpcm[i].step = (UINT32)((float)(1<<ADPCM_SHIFT)*((float)OPN->ST.freqbase)/6.0);
+	}
+}
+
 void ym2608_set_mutemask(void *chip, UINT32 MuteMask)
 {
 	YM2608 *F2608 = (YM2608 *)chip;
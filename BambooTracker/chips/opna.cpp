@@ -1,5 +1,6 @@
 #include "opna.hpp"
 #include <cmath>
+#include <algorithm>
 #include "chip_misc.h"
 
 #ifdef  __cplusplus
@@ -21,21 +22,25 @@ namespace chip
 
 	OPNA::OPNA(int clock, int rate, size_t maxDuration,
 			   std::unique_ptr<AbstractResampler> fmResampler, std::unique_ptr<AbstractResampler> ssgResampler,
-			   std::shared_ptr<ExportContainerInterface> exportContainer)
+			   std::shared_ptr<ExportContainerInterface> exportContainer, SSGEmulator ssgEmulator)
 		: Chip(count_++, clock, rate, 110933, maxDuration,
 			   std::move(fmResampler), std::move(ssgResampler),	// autoRate = 110933: FM internal rate
 			   exportContainer),
+		  ssgEmu_(ssgEmulator),
+		  mixMode_(MixMode::SEPARATE),
+		  fmRateRatio_(1),
 		  scciManager_(nullptr),
 		  scciChip_(nullptr)
 	{
 		funcSetRate(rate);
 
-		UINT8 EmuCore = 0;
+		UINT8 EmuCore = static_cast<UINT8>(ssgEmu_);
 		ym2608_set_ay_emu_core(EmuCore);
 
 		UINT8 AYDisable = 0;	// Enable
 		UINT8 AYFlags = 0;		// None
 		internalRate_[FM] = device_start_ym2608(id_, clock, AYDisable, AYFlags, reinterpret_cast<int*>(&internalRate_[SSG]));
+		fmNativeRate_ = internalRate_[FM];
 
 		initResampler();
 
@@ -94,6 +99,57 @@ namespace chip
 		return ym2608_read_port_r(id_, 1);
 	}
 
+	void OPNA::setRate(int rate)
+	{
+		std::lock_guard<std::mutex> lg(mutex_);
+
+		funcSetRate(rate);
+		updateInternalRates();
+	}
+
+	SSGEmulator OPNA::getSSGEmulator() const
+	{
+		return ssgEmu_;
+	}
+
+	void OPNA::setMixMode(MixMode mode)
+	{
+		std::lock_guard<std::mutex> lg(mutex_);
+
+		// emu2149 runs only at its own rate, so it is always resampled separately
+		mixMode_ = (ssgEmu_ == SSGEmulator::BLEP) ? mode : MixMode::SEPARATE;
+		updateInternalRates();
+	}
+
+	MixMode OPNA::getMixMode() const
+	{
+		return mixMode_;
+	}
+
+	void OPNA::updateInternalRates()
+	{
+		switch (mixMode_) {
+		case MixMode::SEPARATE:
+			internalRate_[FM] = fmNativeRate_;
+			// BLEP core follows the output rate and skips its resampler
+			internalRate_[SSG] = ym2608_set_ay_rate(id_, rate_);
+			break;
+		case MixMode::SINGLE_RESAMPLE:
+			internalRate_[FM] = fmNativeRate_;
+			internalRate_[SSG] = ym2608_set_ay_rate(id_, fmNativeRate_);
+			break;
+		case MixMode::INTEGER_RATIO:
+			// Nearest multiple of the output rate to the FM synthesis rate
+			fmRateRatio_ = std::max(1, static_cast<int>(std::lround(static_cast<double>(fmNativeRate_) / rate_)));
+			internalRate_[FM] = rate_ * fmRateRatio_;
+			internalRate_[SSG] = ym2608_set_ay_rate(id_, internalRate_[FM]);
+			break;
+		}
+
+		ym2608_set_fm_rate(id_, internalRate_[FM]);
+
+		initResampler();
+	}
 
 	void OPNA::setVolumeFM(double dB)
 	{
@@ -110,6 +166,24 @@ namespace chip
 	void OPNA::mix(int16_t* stream, size_t nSamples)
 	{
 		std::lock_guard<std::mutex> lg(mutex_);
+
+		switch (mixMode_) {
+		case MixMode::SEPARATE:
+			mixSeparately(stream, nSamples);
+			break;
+		case MixMode::SINGLE_RESAMPLE:
+			mixAndResample(stream, nSamples);
+			break;
+		case MixMode::INTEGER_RATIO:
+			mixAndDecimate(stream, nSamples);
+			break;
+		}
+
+		if (exCntr_) exCntr_->recordStream(stream, nSamples);
+	}
+
+	void OPNA::mixSeparately(int16_t* stream, size_t nSamples)
+	{
 		sample **bufFM, **bufSSG;
 
 		// Set FM buffer
@@ -140,8 +214,54 @@ namespace chip
 				*p++ = static_cast<int16_t>(clamp(s * masterVolumeRatio_, -32768.0, 32767.0));
 			}
 		}
+	}
+
+	void OPNA::mixAndResample(int16_t* stream, size_t nSamples)
+	{
+		// FM and SSG share the internal rate
+		size_t intrSize = (internalRate_[FM] == rate_) ? nSamples
+													   : resampler_[FM]->calculateInternalSampleSize(nSamples);
+		ym2608_stream_update(id_, buffer_[FM], intrSize);
+		ym2608_stream_update_ay(id_, buffer_[SSG], intrSize);
+
+		for (int pan = LEFT; pan <= RIGHT; ++pan) {
+			for (size_t i = 0; i < intrSize; ++i) {
+				buffer_[FM][pan][i] = static_cast<sample>(volumeRatio_[FM] * buffer_[FM][pan][i]
+														  + volumeRatio_[SSG] * buffer_[SSG][pan][i]);
+			}
+		}
 
-		if (exCntr_) exCntr_->recordStream(stream, nSamples);
+		sample** buf = (internalRate_[FM] == rate_) ? buffer_[FM]
+													: resampler_[FM]->interpolate(buffer_[FM], nSamples, intrSize);
+		int16_t* p = stream;
+		for (size_t i = 0; i < nSamples; ++i) {
+			for (int pan = LEFT; pan <= RIGHT; ++pan) {
+				*p++ = static_cast<int16_t>(clamp(buf[pan][i] * masterVolumeRatio_, -32768.0, 32767.0));
+			}
+		}
+	}
+
+	void OPNA::mixAndDecimate(int16_t* stream, size_t nSamples)
+	{
+		// Internal rate is fmRateRatio_ times the output rate
+		size_t intrSize = nSamples * static_cast<size_t>(fmRateRatio_);
+		ym2608_stream_update(id_, buffer_[FM], intrSize);
+		ym2608_stream_update_ay(id_, buffer_[SSG], intrSize);
+
+		double volFM = volumeRatio_[FM] * masterVolumeRatio_ / fmRateRatio_;
+		double volSSG = volumeRatio_[SSG] * masterVolumeRatio_ / fmRateRatio_;
+		int16_t* p = stream;
+		for (size_t i = 0, n = 0; i < nSamples; ++i, n += fmRateRatio_) {
+			for (int pan = LEFT; pan <= RIGHT; ++pan) {
+				sample sumFM = 0, sumSSG = 0;
+				for (size_t k = n, end = n + fmRateRatio_; k < end; ++k) {
+					sumFM += buffer_[FM][pan][k];
+					sumSSG += buffer_[SSG][pan][k];
+				}
+				double s = volFM * sumFM + volSSG * sumSSG;
+				*p++ = static_cast<int16_t>(clamp(s, -32768.0, 32767.0));
+			}
+		}
 	}
 
 	void OPNA::useSCCI(SoundInterfaceManager* manager)
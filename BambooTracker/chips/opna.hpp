@@ -6,6 +6,21 @@
 
 namespace chip
 {
+	enum class SSGEmulator : int
+	{
+		EMU2149	= 0x00,	// Run at the internal SSG rate and resample
+		BLEP	= 0x02	// Band-limited synthesis at the output rate
+	};
+
+	// Domain in which FM and SSG are summed.
+	// SINGLE_RESAMPLE and INTEGER_RATIO need the BLEP SSG core
+	enum class MixMode : int
+	{
+		SEPARATE,			// Resample FM and SSG separately, then sum
+		SINGLE_RESAMPLE,	// Render SSG at the FM rate, sum and resample once
+		INTEGER_RATIO		// Render both at an integer multiple of the output rate and decimate
+	};
+
 	class OPNA : public Chip
 	{
 	public:
@@ -14,12 +29,17 @@ namespace chip
 		OPNA(int clock, int rate, size_t maxDuration,
 			 std::unique_ptr<AbstractResampler> fmResampler = std::make_unique<LinearResampler>(),
 			 std::unique_ptr<AbstractResampler> ssgResampler = std::make_unique<LinearResampler>(),
-			 std::shared_ptr<ExportContainerInterface> exportContainer = nullptr);
+			 std::shared_ptr<ExportContainerInterface> exportContainer = nullptr,
+			 SSGEmulator ssgEmulator = SSGEmulator::EMU2149);
 		~OPNA() override;
 
 		void reset() override;
 		void setRegister(uint32_t offset, uint8_t value) override;
 		uint8_t getRegister(uint32_t offset) const override;
+		void setRate(int rate) override;
+		SSGEmulator getSSGEmulator() const;
+		void setMixMode(MixMode mode);
+		MixMode getMixMode() const;
 		void setVolumeFM(double dB);
 		void setVolumeSSG(double dB);
 		void mix(int16_t* stream, size_t nSamples) override;
@@ -29,12 +49,22 @@ namespace chip
 	private:
 		static size_t count_;
 
+		const SSGEmulator ssgEmu_;
+		MixMode mixMode_;
+		int fmNativeRate_;
+		int fmRateRatio_;
+
 		// For SCCI
 		SoundInterfaceManager* scciManager_;
 		SoundChip* scciChip_;
 
 		static const double VOL_REDUC;
 
+		void updateInternalRates();
+		void mixSeparately(int16_t* stream, size_t nSamples);
+		void mixAndResample(int16_t* stream, size_t nSamples);
+		void mixAndDecimate(int16_t* stream, size_t nSamples);
+
 		enum SoundSource : int
 		{
 			FM  = 0,
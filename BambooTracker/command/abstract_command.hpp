@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 struct AbstractCommand
 {
 	virtual ~AbstractCommand() {}
@@ -10,4 +12,10 @@ struct AbstractCommand
 	{
 		return false;
 	}
+	/// Approximate bytes held by the command.
+	/// Commands keeping only a few values use this rough default
+	virtual size_t getMemorySize() const
+	{
+		return 64;
+	}
 };
@@ -1,38 +1,123 @@
 #include "command_manager.hpp"
 #include <utility>
 
-CommandManager::CommandManager() {}
+constexpr size_t CommandManager::DEFAULT_MEMORY_LIMIT;
+
+CommandManager::CommandManager(size_t memoryLimit)
+	: memLimit_(memoryLimit),
+	  memUsage_(0),
+	  changeCnt_(0),
+	  compoundDepth_(0)
+{
+}
 
 void CommandManager::invoke(CommandIPtr command)
 {
 	command->redo();
+	++changeCnt_;
+
+	if (compoundDepth_) compound_->append(std::move(command));
+	else push(std::move(command));
+}
 
-	redoStack_ = std::stack<CommandIPtr>();
-	if (undoStack_.empty() || !undoStack_.top()->mergeWith(command.get())) {
-		undoStack_.push(std::move(command));
+void CommandManager::push(CommandIPtr command)
+{
+	clearRedoStack();
+	if (!undoStack_.empty()) {
+		size_t prevSize = undoStack_.back()->getMemorySize();
+		if (undoStack_.back()->mergeWith(command.get())) {
+			memUsage_ = memUsage_ - prevSize + undoStack_.back()->getMemorySize();
+			trimUndoStack();
+			return;
+		}
 	}
+	memUsage_ += command->getMemorySize();
+	undoStack_.push_back(std::move(command));
+	trimUndoStack();
 }
 
 void CommandManager::undo()
 {
 	if (undoStack_.empty()) return;
-	CommandIPtr command = std::move(undoStack_.top());
+	CommandIPtr command = std::move(undoStack_.back());
 	command->undo();
-	undoStack_.pop();
-	redoStack_.push(std::move(command));
+	++changeCnt_;
+	undoStack_.pop_back();
+	redoStack_.push_back(std::move(command));
 }
 
 void CommandManager::redo()
 {
 	if (redoStack_.empty()) return;
-	CommandIPtr command = std::move(redoStack_.top());
+	CommandIPtr command = std::move(redoStack_.back());
 	command->redo();
-	redoStack_.pop();
-	undoStack_.push(std::move(command));
+	++changeCnt_;
+	redoStack_.pop_back();
+	undoStack_.push_back(std::move(command));
 }
 
 void CommandManager::clear()
 {
-	redoStack_ = std::stack<CommandIPtr>();
-	undoStack_ = std::stack<CommandIPtr>();
+	redoStack_.clear();
+	undoStack_.clear();
+	memUsage_ = 0;
+}
+
+bool CommandManager::canUndo() const
+{
+	return !undoStack_.empty();
+}
+
+bool CommandManager::canRedo() const
+{
+	return !redoStack_.empty();
+}
+
+size_t CommandManager::getChangeCount() const
+{
+	return changeCnt_;
+}
+
+void CommandManager::beginCompound()
+{
+	if (!compoundDepth_++) compound_ = std::make_unique<CompoundCommand>();
+}
+
+void CommandManager::endCompound()
+{
+	if (!compoundDepth_ || --compoundDepth_) return;
+
+	if (!compound_->empty()) push(std::move(compound_));
+	compound_.reset();
+}
+
+void CommandManager::setMemoryLimit(size_t bytes)
+{
+	memLimit_ = bytes;
+	trimUndoStack();
+}
+
+size_t CommandManager::getMemoryLimit() const
+{
+	return memLimit_;
+}
+
+size_t CommandManager::getMemoryUsage() const
+{
+	return memUsage_;
+}
+
+void CommandManager::clearRedoStack()
+{
+	for (auto& command : redoStack_) memUsage_ -= command->getMemorySize();
+	redoStack_.clear();
+}
+
+/// The latest command is always kept even if it exceeds the limit by itself
+void CommandManager::trimUndoStack()
+{
+	while (memUsage_ > memLimit_ && undoStack_.size() > 1) {
+		memUsage_ -= undoStack_.front()->getMemorySize();
+		undoStack_.pop_front();
+	}
 }
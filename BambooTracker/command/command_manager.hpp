@@ -1,21 +1,49 @@
 #pragma once
 
-#include <stack>
+#include <deque>
 #include <memory>
+#include <cstddef>
 #include "abstract_command.hpp"
+#include "compound_command.hpp"
 
 class CommandManager
 {
 public:
 	using CommandIPtr = std::unique_ptr<AbstractCommand>;
 
-	CommandManager();
+	explicit CommandManager(size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
 	void invoke(CommandIPtr command);
 	void undo();
 	void redo();
 	void clear();
+	bool canUndo() const;
+	bool canRedo() const;
+	/// Incremented whenever a command is executed, undone or redone.
+	/// Caches of the module compare it to detect edits
+	size_t getChangeCount() const;
+
+	/// Commands invoked until the matching endCompound are stored as one command.
+	/// They can be nested
+	void beginCompound();
+	void endCompound();
+
+	/// Oldest undo commands are discarded when the history exceeds the limit
+	void setMemoryLimit(size_t bytes);
+	size_t getMemoryLimit() const;
+	size_t getMemoryUsage() const;
+
+	static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
 
 private:
-	std::stack<CommandIPtr> undoStack_;
-	std::stack<CommandIPtr> redoStack_;
+	std::deque<CommandIPtr> undoStack_;
+	std::deque<CommandIPtr> redoStack_;
+	size_t memLimit_, memUsage_;
+	size_t changeCnt_;
+	std::unique_ptr<CompoundCommand> compound_;
+	int compoundDepth_;
+
+	void push(CommandIPtr command);
+
+	void clearRedoStack();
+	void trimUndoStack();
 };
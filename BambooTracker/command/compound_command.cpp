@@ -0,0 +1,35 @@
+#include "compound_command.hpp"
+#include <utility>
+
+void CompoundCommand::append(std::unique_ptr<AbstractCommand> command)
+{
+	if (commands_.empty() || !commands_.back()->mergeWith(command.get()))
+		commands_.push_back(std::move(command));
+}
+
+bool CompoundCommand::empty() const
+{
+	return commands_.empty();
+}
+
+void CompoundCommand::redo()
+{
+	for (auto& command : commands_) command->redo();
+}
+
+void CompoundCommand::undo()
+{
+	for (auto it = commands_.rbegin(); it != commands_.rend(); ++it) (*it)->undo();
+}
+
+int CompoundCommand::getID() const
+{
+	return 0x48;
+}
+
+size_t CompoundCommand::getMemorySize() const
+{
+	size_t size = sizeof(*this) + commands_.capacity() * sizeof(std::unique_ptr<AbstractCommand>);
+	for (auto& command : commands_) size += command->getMemorySize();
+	return size;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include "abstract_command.hpp"
+
+/// Group of commands undone and redone as one
+class CompoundCommand : public AbstractCommand
+{
+public:
+	/// Add the command which has already been executed
+	void append(std::unique_ptr<AbstractCommand> command);
+	bool empty() const;
+
+	void redo() override;
+	void undo() override;
+	int getID() const override;
+	size_t getMemorySize() const override;
+
+private:
+	std::vector<std::unique_ptr<AbstractCommand>> commands_;
+};
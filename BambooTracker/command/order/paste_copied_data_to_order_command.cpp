@@ -2,7 +2,7 @@
 #include "track.hpp"
 
 PasteCopiedDataToOrderCommand::PasteCopiedDataToOrderCommand(std::weak_ptr<Module> mod, int songNum, int beginTrack, int beginOrder,
-															 std::vector<std::vector<std::string>> cells)
+															 std::vector<std::vector<int>> cells)
 	: mod_(mod),
 	  song_(songNum),
 	  track_(beginTrack),
@@ -14,7 +14,7 @@ PasteCopiedDataToOrderCommand::PasteCopiedDataToOrderCommand(std::weak_ptr<Modul
 		prevCells_.emplace_back();
 		std::vector<OrderData> odrs = sng.getOrderData(beginOrder + i);
 		for (size_t j = 0; j < cells.at(i).size(); ++j) {
-			prevCells_.at(i).push_back(std::to_string(odrs.at(beginTrack + j).patten));
+			prevCells_.at(i).push_back(odrs.at(beginTrack + j).patten);
 		}
 	}
 }
@@ -34,13 +34,13 @@ int PasteCopiedDataToOrderCommand::getID() const
 	return 0x43;
 }
 
-void PasteCopiedDataToOrderCommand::setCells(std::vector<std::vector<std::string>>& cells)
+void PasteCopiedDataToOrderCommand::setCells(std::vector<std::vector<int>>& cells)
 {
 	auto& sng = mod_.lock()->getSong(song_);
 
 	for (size_t i = 0; i < cells.size(); ++i) {
 		for (size_t j = 0; j < cells.at(i).size(); ++j) {
-			sng.getTrack(track_ + j).registerPatternToOrder(order_ + i, std::stoi(cells.at(i).at(j)));
+			sng.getTrack(track_ + j).registerPatternToOrder(order_ + i, cells.at(i).at(j));
 		}
 	}
 }
@@ -10,7 +10,7 @@ class PasteCopiedDataToOrderCommand : public AbstractCommand
 {
 public:
 	PasteCopiedDataToOrderCommand(std::weak_ptr<Module> mod, int songNum, int beginTrack, int beginOrder,
-								  std::vector<std::vector<std::string>> cells);
+								  std::vector<std::vector<int>> cells);
   void redo() override;
   void undo() override;
   int getID() const override;
@@ -18,7 +18,7 @@ public:
 private:
   std::weak_ptr<Module> mod_;
   int song_, track_, order_;
-  std::vector<std::vector<std::string>> cells_, prevCells_;
+  std::vector<std::vector<int>> cells_, prevCells_;
 
-  void setCells(std::vector<std::vector<std::string>>& cells);
+  void setCells(std::vector<std::vector<int>>& cells);
 };
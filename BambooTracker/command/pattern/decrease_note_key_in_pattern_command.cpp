@@ -14,12 +14,12 @@ DecreaseNoteKeyInPatternCommand::DecreaseNoteKeyInPatternCommand(std::weak_ptr<M
 {
 	auto& sng = mod.lock()->getSong(songNum);
 
-	for (int step = beginStep; step <= endStep; ++step) {
-		for (int track = beginTrack; track <= endTrack; ++track) {
-			int n = sng.getTrack(track).getPatternFromOrderNumber(beginOrder)
-					.getStep(step).getNoteNumber();
+	for (int track = beginTrack; track <= endTrack; ++track) {
+		const Pattern& pt = sng.getTrack(track).getPatternFromOrderNumber(beginOrder);
+		pt.forEachStep(beginStep, endStep, [&](int, const Step& s) {
+			int n = s.getNoteNumber();
 			if (n > -1) prevKeys_.push_back(n);
-		}
+		});
 	}
 }
 
@@ -27,15 +27,15 @@ void DecreaseNoteKeyInPatternCommand::redo()
 {
 	auto& sng = mod_.lock()->getSong(song_);
 
-	for (int step = bStep_; step <= eStep_; ++step) {
-		for (int track = bTrack_; track <= eTrack_; ++track) {
-			auto& s = sng.getTrack(track).getPatternFromOrderNumber(order_).getStep(step);
+	for (int track = bTrack_; track <= eTrack_; ++track) {
+		sng.getTrack(track).getPatternFromOrderNumber(order_)
+				.forEachStep(bStep_, eStep_, [](int, Step& s) {
 			int n = s.getNoteNumber();
 			if (n >= 0) {
 				n = (n == 0)? 0 : (n - 1);
 				s.setNoteNumber(n);
 			}
-		}
+		});
 	}
 }
 
@@ -44,11 +44,11 @@ void DecreaseNoteKeyInPatternCommand::undo()
 	auto& sng = mod_.lock()->getSong(song_);
 
 	size_t i = 0;
-	for (int step = bStep_; step <= eStep_; ++step) {
-		for (int track = bTrack_; track <= eTrack_; ++track) {
-			auto& s = sng.getTrack(track).getPatternFromOrderNumber(order_).getStep(step);
-			 if (s.getNoteNumber() > -1) s.setNoteNumber(prevKeys_.at(i));
-		}
+	for (int track = bTrack_; track <= eTrack_; ++track) {
+		sng.getTrack(track).getPatternFromOrderNumber(order_)
+				.forEachStep(bStep_, eStep_, [&](int, Step& s) {
+			if (s.getNoteNumber() > -1) s.setNoteNumber(prevKeys_.at(i++));
+		});
 	}
 }
 
@@ -30,7 +30,7 @@ void DeletePreviousStepCommand::undo()
 	pt.insertStep(step_ - 1);	// Insert previous step
 	auto& st = pt.getStep(step_ - 1);
 	st.setNoteNumber(prevNote_);
-	st.setInstrumentNumber(prevInst_);
+	pt.setStepInstrumentNumber(step_ - 1, prevInst_);
 	st.setVolume(prevVol_);
 	for (int i = 0; i < 4; ++i) {
 		st.setEffectID(i, prevEffID_[i]);
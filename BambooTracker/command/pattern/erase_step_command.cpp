@@ -19,9 +19,10 @@ EraseStepCommand::EraseStepCommand(std::weak_ptr<Module> mod, int songNum, int t
 
 void EraseStepCommand::redo()
 {
-	auto& st = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_).getStep(step_);
+	auto& pt = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_);
+	auto& st = pt.getStep(step_);
 	st.setNoteNumber(-1);
-	st.setInstrumentNumber(-1);
+	pt.setStepInstrumentNumber(step_, -1);
 	st.setVolume(-1);
 	for (int i = 0; i < 4; ++i){
 		st.setEffectID(i, "--");
@@ -31,9 +32,10 @@ void EraseStepCommand::redo()
 
 void EraseStepCommand::undo()
 {
-	auto& st = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_).getStep(step_);
+	auto& pt = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_);
+	auto& st = pt.getStep(step_);
 	st.setNoteNumber(prevNote_);
-	st.setInstrumentNumber(prevInst_);
+	pt.setStepInstrumentNumber(step_, prevInst_);
 	st.setVolume(prevVol_);
 	for (int i = 0; i < 4; ++i) {
 		st.setEffectID(i, prevEffID_[i]);
@@ -5,6 +5,7 @@
 #include <vector>
 #include <string>
 #include "module.hpp"
+#include "pattern_cells_backup.hpp"
 
 class InterpolatePatternCommand : public AbstractCommand
 {
@@ -15,10 +16,11 @@ public:
 	void redo() override;
 	void undo() override;
 	int getID() const override;
+	size_t getMemorySize() const override;
 
 private:
 	std::weak_ptr<Module> mod_;
 	int song_, bTrack_, bCol_, order_, bStep_;
 	int eTrack_, eCol_, eStep_;
-	std::vector<std::vector<std::string>> prevCells_;
+	PatternCellsBackup prevCells_;
 };
@@ -2,7 +2,7 @@
 
 PasteCopiedDataToPatternCommand::PasteCopiedDataToPatternCommand(std::weak_ptr<Module> mod, int songNum, int beginTrack, int beginColmn,
 																 int beginOrder, int beginStep,
-																 std::vector<std::vector<std::string>> cells)
+																 PatternCells cells)
 	: mod_(mod),
 	  song_(songNum),
 	  track_(beginTrack),
@@ -12,75 +12,36 @@ PasteCopiedDataToPatternCommand::PasteCopiedDataToPatternCommand(std::weak_ptr<M
 	  cells_(cells)
 {
 	auto& sng = mod.lock()->getSong(songNum);
-	int s = beginStep;
-	for (size_t i = 0; i < cells.size(); ++i) {
-		prevCells_.emplace_back();
-		int t = beginTrack;
-		int c = beginColmn;
-		for (size_t j = 0; j < cells.at(i).size(); ++j) {
-			switch (c) {
-			case 0:
-				prevCells_.at(i).push_back(std::to_string(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getNoteNumber()));
-				break;
-			case 1:
-				prevCells_.at(i).push_back(std::to_string(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getInstrumentNumber()));
-				break;
-			case 2:
-				prevCells_.at(i).push_back(std::to_string(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getVolume()));
-				break;
-			case 3:
-				prevCells_.at(i).push_back(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getEffectID(0));
-				break;
-			case 4:
-				prevCells_.at(i).push_back(std::to_string(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getEffectValue(0)));
-				break;
-			case 5:
-				prevCells_.at(i).push_back(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getEffectID(1));
-				break;
-			case 6:
-				prevCells_.at(i).push_back(std::to_string(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getEffectValue(1)));
-				break;
-			case 7:
-				prevCells_.at(i).push_back(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getEffectID(2));
-				break;
-			case 8:
-				prevCells_.at(i).push_back(std::to_string(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getEffectValue(2)));
-				break;
-			case 9:
-				prevCells_.at(i).push_back(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getEffectID(3));
-				break;
-			case 10:
-				prevCells_.at(i).push_back(std::to_string(
-							sng.getTrack(t).getPatternFromOrderNumber(beginOrder).getStep(s).getEffectValue(3)));
-				break;
-			}
+	prevCells_ = PatternCellsBackup(sng, beginOrder, beginTrack, beginColmn, beginStep,
+									cells.getRowCount(), cells.getColumnCount());
+}
+
+void PasteCopiedDataToPatternCommand::redo()
+{
+	auto& sng = mod_.lock()->getSong(song_);
+
+	size_t cols = cells_.getColumnCount();
+	int s = step_;
+	for (size_t i = 0; i < cells_.getRowCount(); ++i) {
+		int t = track_;
+		int c = col_;
+		Pattern* pattern = &sng.getTrack(t).getPatternFromOrderNumber(order_);
+		for (size_t j = 0; j < cols; ++j) {
+			PatternCells::writeCell(*pattern, s, c, cells_.getValue(i, j));
 
 			++c;
-			t += (c / 11);
-			c %= 11;
+			if (c == 11 && j + 1 < cols) {
+				pattern = &sng.getTrack(++t).getPatternFromOrderNumber(order_);
+				c = 0;
+			}
 		}
 		++s;
 	}
 }
 
-void PasteCopiedDataToPatternCommand::redo()
-{
-	setCells(cells_);
-}
-
 void PasteCopiedDataToPatternCommand::undo()
 {
-	setCells(prevCells_);
+	prevCells_.restore(mod_.lock()->getSong(song_));
 }
 
 int PasteCopiedDataToPatternCommand::getID() const
@@ -88,67 +49,7 @@ int PasteCopiedDataToPatternCommand::getID() const
 	return 0x2d;
 }
 
-void PasteCopiedDataToPatternCommand::setCells(std::vector<std::vector<std::string>>& cells)
+size_t PasteCopiedDataToPatternCommand::getMemorySize() const
 {
-	auto& sng = mod_.lock()->getSong(song_);
-
-	int s = step_;
-	for (size_t i = 0; i < cells.size(); ++i) {
-		int t = track_;
-		int c = col_;
-		for (size_t j = 0; j < cells.at(i).size(); ++j) {
-			switch (c) {
-			case 0:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setNoteNumber(std::stoi(cells.at(i).at(j)));
-				break;
-			case 1:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setInstrumentNumber(std::stoi(cells.at(i).at(j)));
-				break;
-			case 2:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setVolume(std::stoi(cells.at(i).at(j)));
-				break;
-			case 3:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setEffectID(0, cells.at(i).at(j));
-				break;
-			case 4:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setEffectValue(0, std::stoi(cells.at(i).at(j)));
-				break;
-			case 5:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setEffectID(1, cells.at(i).at(j));
-				break;
-			case 6:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setEffectValue(1, std::stoi(cells.at(i).at(j)));
-				break;
-			case 7:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setEffectID(2, cells.at(i).at(j));
-				break;
-			case 8:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setEffectValue(2, std::stoi(cells.at(i).at(j)));
-				break;
-			case 9:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setEffectID(3, cells.at(i).at(j));
-				break;
-			case 10:
-				sng.getTrack(t).getPatternFromOrderNumber(order_).getStep(s)
-						.setEffectValue(3, std::stoi(cells.at(i).at(j)));
-				break;
-			}
-
-			++c;
-			t += (c / 11);
-			c %= 11;
-		}
-
-		++s;
-	}
+	return sizeof(*this) + cells_.getMemorySize() + prevCells_.getMemorySize();
 }
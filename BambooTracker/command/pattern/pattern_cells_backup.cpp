@@ -0,0 +1,69 @@
+#include "pattern_cells_backup.hpp"
+
+PatternCellsBackup::PatternCellsBackup()
+	: order_(0),
+	  bTrack_(0),
+	  bCol_(0),
+	  bStep_(0)
+{
+}
+
+PatternCellsBackup::PatternCellsBackup(Song& sng, int order, int beginTrack, int beginColumn, int beginStep,
+									   size_t rows, size_t columns)
+	: order_(order),
+	  bTrack_(beginTrack),
+	  bCol_(beginColumn),
+	  bStep_(beginStep),
+	  cells_(sng, order, beginTrack, beginColumn, beginStep, rows, columns)
+{
+}
+
+size_t PatternCellsBackup::getRowCount() const
+{
+	return cells_.getRowCount();
+}
+
+size_t PatternCellsBackup::getColumnCount() const
+{
+	return cells_.getColumnCount();
+}
+
+size_t PatternCellsBackup::getMemorySize() const
+{
+	return cells_.getMemorySize();
+}
+
+void PatternCellsBackup::restore(Song& sng) const
+{
+	for (size_t i = 0; i < cells_.getRowCount(); ++i) {
+		writeRow(sng, bStep_ + static_cast<int>(i), static_cast<int>(i));
+	}
+}
+
+void PatternCellsBackup::restoreRow(Song& sng, size_t row, int step) const
+{
+	writeRow(sng, step, static_cast<int>(row));
+}
+
+void PatternCellsBackup::clearRow(Song& sng, int step) const
+{
+	writeRow(sng, step, -1);
+}
+
+void PatternCellsBackup::writeRow(Song& sng, int step, int row) const
+{
+	int t = bTrack_;
+	int c = bCol_;
+	size_t cols = cells_.getColumnCount();
+	Pattern* pattern = &sng.getTrack(t).getPatternFromOrderNumber(order_);
+	for (size_t j = 0; j < cols; ++j) {
+		int16_t value = (row == -1) ? PatternCells::getBlankValue(c) : cells_.getValue(row, j);
+		PatternCells::writeCell(*pattern, step, c, value);
+
+		++c;
+		if (c == 11 && j + 1 < cols) {
+			pattern = &sng.getTrack(++t).getPatternFromOrderNumber(order_);
+			c = 0;
+		}
+	}
+}
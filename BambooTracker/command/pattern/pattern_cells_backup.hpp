@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include "song.hpp"
+#include "pattern_cells.hpp"
+
+/// Copy of a rectangular range of pattern cells kept for undo
+class PatternCellsBackup
+{
+public:
+	PatternCellsBackup();
+	PatternCellsBackup(Song& sng, int order, int beginTrack, int beginColumn, int beginStep,
+					   size_t rows, size_t columns);
+
+	size_t getRowCount() const;
+	size_t getColumnCount() const;
+	/// Bytes allocated for the cells
+	size_t getMemorySize() const;
+
+	/// Write all rows back to the steps they were taken from
+	void restore(Song& sng) const;
+	/// Write the row to the given step
+	void restoreRow(Song& sng, size_t row, int step) const;
+	/// Erase the columns of the range in the given step
+	void clearRow(Song& sng, int step) const;
+
+private:
+	int order_, bTrack_, bCol_, bStep_;
+	PatternCells cells_;
+
+	/// Blank cells are written when row is -1
+	void writeRow(Song& sng, int step, int row) const;
+};
@@ -15,12 +15,12 @@ ReplaceInstrumentInPatternCommand::ReplaceInstrumentInPatternCommand(std::weak_p
 {
 	auto& sng = mod.lock()->getSong(songNum);
 
-	for (int step = beginStep; step <= endStep; ++step) {
-		for (int track = beginTrack; track <= endTrack; ++track) {
-			int n = sng.getTrack(track).getPatternFromOrderNumber(beginOrder)
-					.getStep(step).getInstrumentNumber();
+	for (int track = beginTrack; track <= endTrack; ++track) {
+		const Pattern& pt = sng.getTrack(track).getPatternFromOrderNumber(beginOrder);
+		pt.forEachStep(beginStep, endStep, [&](int, const Step& s) {
+			int n = s.getInstrumentNumber();
 			if (n > -1) prevInsts_.push_back(n);
-		}
+		});
 	}
 }
 
@@ -28,12 +28,11 @@ void ReplaceInstrumentInPatternCommand::redo()
 {
 	auto& sng = mod_.lock()->getSong(song_);
 
-	for (int step = bStep_; step <= eStep_; ++step) {
-		for (int track = bTrack_; track <= eTrack_; ++track) {
-			auto& s = sng.getTrack(track).getPatternFromOrderNumber(order_).getStep(step);
-			int n = s.getInstrumentNumber();
-			if (n > -1) s.setInstrumentNumber(inst_);
-		}
+	for (int track = bTrack_; track <= eTrack_; ++track) {
+		auto& pt = sng.getTrack(track).getPatternFromOrderNumber(order_);
+		pt.forEachStep(bStep_, eStep_, [&](int step, Step& s) {
+			if (s.getInstrumentNumber() > -1) pt.setStepInstrumentNumber(step, inst_);
+		});
 	}
 }
 
@@ -42,11 +41,11 @@ void ReplaceInstrumentInPatternCommand::undo()
 	auto& sng = mod_.lock()->getSong(song_);
 
 	size_t i = 0;
-	for (int step = bStep_; step <= eStep_; ++step) {
-		for (int track = bTrack_; track <= eTrack_; ++track) {
-			auto& s = sng.getTrack(track).getPatternFromOrderNumber(order_).getStep(step);
-			 if (s.getInstrumentNumber() > -1) s.setInstrumentNumber(prevInsts_.at(i));
-		}
+	for (int track = bTrack_; track <= eTrack_; ++track) {
+		auto& pt = sng.getTrack(track).getPatternFromOrderNumber(order_);
+		pt.forEachStep(bStep_, eStep_, [&](int step, Step& s) {
+			if (s.getInstrumentNumber() > -1) pt.setStepInstrumentNumber(step, prevInsts_.at(i++));
+		});
 	}
 }
 
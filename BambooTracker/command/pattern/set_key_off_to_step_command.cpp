@@ -19,9 +19,10 @@ SetKeyOffToStepCommand::SetKeyOffToStepCommand(std::weak_ptr<Module> mod, int so
 
 void SetKeyOffToStepCommand::redo()
 {
-	auto& st = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_).getStep(step_);
+	auto& pt = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_);
+	auto& st = pt.getStep(step_);
 	st.setNoteNumber(-2);
-	st.setInstrumentNumber(-1);
+	pt.setStepInstrumentNumber(step_, -1);
 	st.setVolume(-1);
 	for (int i = 0; i < 4; ++i) {
 		st.setEffectID(i, "--");
@@ -31,9 +32,10 @@ void SetKeyOffToStepCommand::redo()
 
 void SetKeyOffToStepCommand::undo()
 {
-	auto& st = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_).getStep(step_);
+	auto& pt = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_);
+	auto& st = pt.getStep(step_);
 	st.setNoteNumber(prevNote_);
-	st.setInstrumentNumber(prevInst_);
+	pt.setStepInstrumentNumber(step_, prevInst_);
 	st.setVolume(prevVol_);
 	for (int i = 0; i < 4; ++i) {
 		st.setEffectID(i, prevEffID_[i]);
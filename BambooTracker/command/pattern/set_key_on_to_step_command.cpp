@@ -16,16 +16,18 @@ SetKeyOnToStepCommand::SetKeyOnToStepCommand(std::weak_ptr<Module> mod, int song
 
 void SetKeyOnToStepCommand::redo()
 {
-	auto& st = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_).getStep(step_);
+	auto& pt = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_);
+	auto& st = pt.getStep(step_);
 	st.setNoteNumber(note_);
-	st.setInstrumentNumber(inst_);
+	pt.setStepInstrumentNumber(step_, inst_);
 }
 
 void SetKeyOnToStepCommand::undo()
 {
-	auto& st = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_).getStep(step_);
+	auto& pt = mod_.lock()->getSong(song_).getTrack(track_).getPatternFromOrderNumber(order_);
+	auto& st = pt.getStep(step_);
 	st.setNoteNumber(prevNote_);
-	st.setInstrumentNumber(prevInst_);
+	pt.setStepInstrumentNumber(step_, prevInst_);
 }
 
 int SetKeyOnToStepCommand::getID() const
@@ -26,6 +26,7 @@ Configuration::Configuration()
 	reverseFMVolumeOrder_ = true;
 	moveCursorToRight_ = false;
 	retrieveChannelState_ = false;
+	compressModules_ = false;
 
 	// Edit settings
 	pageJumpLength_ = 4;
@@ -42,6 +43,8 @@ Configuration::Configuration()
 	useSCCI_ = false;
 	sampleRate_ = 44100;
 	bufferLength_ = 40;
+	ssgEmulator_ = 0;
+	mixMode_ = 0;
 
 	// Mixer //
 	mixerVolumeMaster_ = 100;
@@ -668,6 +671,16 @@ bool Configuration::getRetrieveChannelState() const
 	return retrieveChannelState_;
 }
 
+void Configuration::setCompressModules(bool enabled)
+{
+	compressModules_ = enabled;
+}
+
+bool Configuration::getCompressModules() const
+{
+	return compressModules_;
+}
+
 // Edit settings
 void Configuration::setPageJumpLength(size_t length)
 {
@@ -771,6 +784,26 @@ size_t Configuration::getBufferLength() const
 	return bufferLength_;
 }
 
+void Configuration::setSSGEmulator(int emulator)
+{
+	ssgEmulator_ = emulator;
+}
+
+int Configuration::getSSGEmulator() const
+{
+	return ssgEmulator_;
+}
+
+void Configuration::setMixMode(int mode)
+{
+	mixMode_ = mode;
+}
+
+int Configuration::getMixMode() const
+{
+	return mixMode_;
+}
+
 // Mixer //
 void Configuration::setMixerVolumeMaster(int percentage)
 {
@@ -66,12 +66,14 @@ public:
 	bool getMoveCursorToRight() const;
 	void setRetrieveChannelState(bool enabled);
 	bool getRetrieveChannelState() const;
+	void setCompressModules(bool enabled);
+	bool getCompressModules() const;
 private:
 	bool warpCursor_, warpAcrossOrders_;
 	bool showRowNumHex_, showPrevNextOrders_;
 	bool backupModules_, dontSelectOnDoubleClick_;
 	bool reverseFMVolumeOrder_, moveCursorToRight_;
-	bool retrieveChannelState_;
+	bool retrieveChannelState_, compressModules_;
 
 	// Edit settings
 public:
@@ -106,11 +108,19 @@ public:
 	uint32_t getSampleRate() const;
 	void setBufferLength(size_t length);
 	size_t getBufferLength() const;
+	/// Value of chip::SSGEmulator, applied on the next startup
+	void setSSGEmulator(int emulator);
+	int getSSGEmulator() const;
+	/// Value of chip::MixMode, used only with the band-limited SSG emulator
+	void setMixMode(int mode);
+	int getMixMode() const;
 private:
 	std::string sndDevice_;
 	bool useSCCI_;
 	uint32_t sampleRate_;
 	size_t bufferLength_;
+	int ssgEmulator_;
+	int mixMode_;
 
 	// Mixer //
 public:
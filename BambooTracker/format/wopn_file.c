@@ -417,6 +417,24 @@ int WOPN_LoadInstFromMem(OPNIFile *file, void *mem, size_t length)
 #undef GO_FORWARD
 }
 
+int WOPN_LoadBankInstFromMem(WOPNInstrument *ins, void *mem, size_t length, uint16_t version)
+{
+    if(!mem)
+        return WOPN_ERR_NULL_POINTER;
+    if(version > wopn_latest_version)
+        return WOPN_ERR_NEWER_VERSION;
+    if(length < WOPN_BankInstSize(version))
+        return WOPN_ERR_UNEXPECTED_ENDING;
+
+    WOPN_parseInstrument(ins, (uint8_t *)mem, version, 1);
+    return WOPN_ERR_OK;
+}
+
+size_t WOPN_BankInstSize(uint16_t version)
+{
+    return (version > 1) ? WOPN_INST_SIZE_V2 : WOPN_INST_SIZE_V1;
+}
+
 size_t WOPN_CalculateBankFileSize(WOPNFile *file, uint16_t version)
 {
     size_t final_size = 0;
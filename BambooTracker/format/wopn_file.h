@@ -217,6 +217,23 @@ extern WOPNFile *WOPN_LoadBankFromMem(void *mem, size_t length, int *error);
  */
 extern int WOPN_LoadInstFromMem(OPNIFile *file, void *mem, size_t length);
 
+/**
+ * @brief Load one instrument entry of WOPN bank file from the memory.
+ * @param ins Pointer to destination WOPNInstrument structure to fill it with parsed data.
+ * @param mem Pointer to memory block contains raw instrument entry of WOPN bank file data
+ * @param length Length of given memory block
+ * @param version Version of the bank file
+ * @return 0 if no errors occouped, or an error code of WOPN_ErrorCodes enumeration
+ */
+extern int WOPN_LoadBankInstFromMem(WOPNInstrument *ins, void *mem, size_t length, uint16_t version);
+
+/**
+ * @brief Size of an instrument entry in WOPN bank file
+ * @param version Version of the bank file
+ * @return Size of the raw instrument entry
+ */
+extern size_t WOPN_BankInstSize(uint16_t version);
+
 /**
  * @brief Calculate the size of the output memory block
  * @param file Heap-allocated WOPN file data structure
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <QString>
+
+/// MIME types of the binary clipboard data used inside the application.
+/// The text forms ("PATTERN_COPY:", "ORDER_COPY:", ...) are also set for other applications
+namespace ClipboardFormat
+{
+	const QString PATTERN_CELLS = "application/x-bambootracker-pattern-cells";
+	const QString ORDER_CELLS = "application/x-bambootracker-order-cells";
+}
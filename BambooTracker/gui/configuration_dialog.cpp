@@ -1,10 +1,12 @@
 #include "configuration_dialog.hpp"
 #include "ui_configuration_dialog.h"
+#include <algorithm>
 #include <QPushButton>
 #include <QAudio>
 #include <QAudioDeviceInfo>
 #include "slider_style.hpp"
 #include "fm_envelope_set_edit_dialog.hpp"
+#include "chips/opna.hpp"
 
 ConfigurationDialog::ConfigurationDialog(std::weak_ptr<Configuration> config, QWidget *parent)
 	: QDialog(parent),
@@ -31,6 +33,7 @@ ConfigurationDialog::ConfigurationDialog(std::weak_ptr<Configuration> config, QW
 	ui->generalSettingsListWidget->item(6)->setCheckState(toCheckState(config.lock()->getReverseFMVolumeOrder()));
 	ui->generalSettingsListWidget->item(7)->setCheckState(toCheckState(config.lock()->getMoveCursorToRight()));
 	ui->generalSettingsListWidget->item(8)->setCheckState(toCheckState(config.lock()->getRetrieveChannelState()));
+	ui->generalSettingsListWidget->item(9)->setCheckState(toCheckState(config.lock()->getCompressModules()));
 
 	// Edit settings
 	ui->pageJumpLengthSpinBox->setValue(config.lock()->getPageJumpLength());
@@ -74,6 +77,15 @@ ConfigurationDialog::ConfigurationDialog(std::weak_ptr<Configuration> config, QW
 		ui->bufferLengthLabel->setText(QString::number(value) + "ms");
 	});
 	ui->bufferLengthHorizontalSlider->setValue(config.lock()->getBufferLength());
+	ui->ssgEmulatorComboBox->addItem("emu2149", static_cast<int>(chip::SSGEmulator::EMU2149));
+	ui->ssgEmulatorComboBox->addItem(tr("Band-limited"), static_cast<int>(chip::SSGEmulator::BLEP));
+	ui->ssgEmulatorComboBox->setCurrentIndex(
+				std::max(0, ui->ssgEmulatorComboBox->findData(config.lock()->getSSGEmulator())));
+	ui->mixModeComboBox->addItem(tr("Separate"), static_cast<int>(chip::MixMode::SEPARATE));
+	ui->mixModeComboBox->addItem(tr("Single resample"), static_cast<int>(chip::MixMode::SINGLE_RESAMPLE));
+	ui->mixModeComboBox->addItem(tr("Integer ratio"), static_cast<int>(chip::MixMode::INTEGER_RATIO));
+	ui->mixModeComboBox->setCurrentIndex(
+				std::max(0, ui->mixModeComboBox->findData(config.lock()->getMixMode())));
 
 	// Mixer //
 	ui->masterMixerSlider->setText(tr("Master"));
@@ -127,6 +139,7 @@ void ConfigurationDialog::on_ConfigurationDialog_accepted()
 	config_.lock()->setReverseFMVolumeOrder(fromCheckState(ui->generalSettingsListWidget->item(6)->checkState()));
 	config_.lock()->setMoveCursorToRight(fromCheckState(ui->generalSettingsListWidget->item(7)->checkState()));
 	config_.lock()->setRetrieveChannelState(fromCheckState(ui->generalSettingsListWidget->item(8)->checkState()));
+	config_.lock()->setCompressModules(fromCheckState(ui->generalSettingsListWidget->item(9)->checkState()));
 
 	// Edit settings
 	config_.lock()->setPageJumpLength(ui->pageJumpLengthSpinBox->value());
@@ -142,6 +155,8 @@ void ConfigurationDialog::on_ConfigurationDialog_accepted()
 	config_.lock()->setUseSCCI(ui->useSCCICheckBox->checkState() == Qt::Checked);
 	config_.lock()->setSampleRate(ui->sampleRateComboBox->currentData(Qt::UserRole).toInt());
 	config_.lock()->setBufferLength(ui->bufferLengthHorizontalSlider->value());
+	config_.lock()->setSSGEmulator(ui->ssgEmulatorComboBox->currentData(Qt::UserRole).toInt());
+	config_.lock()->setMixMode(ui->mixModeComboBox->currentData(Qt::UserRole).toInt());
 
 	// Mixer //
 	config_.lock()->setMixerVolumeMaster(ui->masterMixerSlider->value());
@@ -184,6 +199,9 @@ void ConfigurationDialog::on_generalSettingsListWidget_itemSelectionChanged()
 	case 8:	// Retrieve channel state
 		text = tr("Reconstruct the current channel's state from previous orders upon playing.");
 		break;
+	case 9:	// Compress modules
+		text = tr("Compress module data when saving a module.");
+		break;
 	default:
 		text = "";
 		break;
@@ -40,6 +40,7 @@ bool ConfigurationHandler::saveConfiguration(std::weak_ptr<Configuration> config
 		settings.setValue("reverseFMVolumeOrder",    configLocked->getReverseFMVolumeOrder());
 		settings.setValue("moveCursorToRight",       configLocked->getMoveCursorToRight());
 		settings.setValue("retrieveChannelState",	configLocked->getRetrieveChannelState());
+		settings.setValue("compressModules",		configLocked->getCompressModules());
 		settings.endGroup();
 
 		// Edit settings
@@ -67,6 +68,8 @@ bool ConfigurationHandler::saveConfiguration(std::weak_ptr<Configuration> config
 		settings.setValue("useSCCI",		configLocked->getUseSCCI());
 		settings.setValue("sampleRate",   static_cast<int>(configLocked->getSampleRate()));
 		settings.setValue("bufferLength", static_cast<int>(configLocked->getBufferLength()));
+		settings.setValue("ssgEmulator",	configLocked->getSSGEmulator());
+		settings.setValue("mixMode",		configLocked->getMixMode());
 		settings.endGroup();
 
 		// Mixer //
@@ -132,6 +135,7 @@ bool ConfigurationHandler::loadConfiguration(std::weak_ptr<Configuration> config
 		configLocked->setReverseFMVolumeOrder(settings.value("reverseFMVolumeOrder", configLocked->getReverseFMVolumeOrder()).toBool());
 		configLocked->setMoveCursorToRight(settings.value("moveCursorToRight", configLocked->getMoveCursorToRight()).toBool());
 		configLocked->setRetrieveChannelState(settings.value("retrieveChannelState", configLocked->getRetrieveChannelState()).toBool());
+		configLocked->setCompressModules(settings.value("compressModules", configLocked->getCompressModules()).toBool());
 		settings.endGroup();
 
 		// Edit settings
@@ -162,6 +166,8 @@ bool ConfigurationHandler::loadConfiguration(std::weak_ptr<Configuration> config
 		QVariant bufferLengthWorkaround;
 		bufferLengthWorkaround.setValue(configLocked->getBufferLength());
 		configLocked->setBufferLength(static_cast<size_t>(settings.value("bufferLength", bufferLengthWorkaround).toInt()));
+		configLocked->setSSGEmulator(settings.value("ssgEmulator", configLocked->getSSGEmulator()).toInt());
+		configLocked->setMixMode(settings.value("mixMode", configLocked->getMixMode()).toInt());
 		settings.endGroup();
 
 		// Mixer //
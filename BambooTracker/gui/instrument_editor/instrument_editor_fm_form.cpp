@@ -18,7 +18,10 @@ InstrumentEditorFMForm::InstrumentEditorFMForm(int num, QWidget *parent) :
 	QWidget(parent),
 	ui(new Ui::InstrumentEditorFMForm),
 	instNum_(num),
-	isIgnoreEvent_(false)
+	isIgnoreEvent_(false),
+	opSeqVersion_(0),
+	arpVersion_(0),
+	ptVersion_(0)
 {
 	ui->setupUi(this);
 
@@ -600,8 +603,8 @@ void InstrumentEditorFMForm::updateInstrumentParameters()
 {
 	Ui::EventGuard eg(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instFM = dynamic_cast<InstrumentFM*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instFM = dynamic_cast<const InstrumentFM*>(inst.get());
 	auto name = QString::fromUtf8(instFM->getName().c_str(), instFM->getName().length());
 	setWindowTitle(QString("%1: %2").arg(instNum_, 2, 16, QChar('0')).toUpper().arg(name));
 
@@ -747,8 +750,8 @@ void InstrumentEditorFMForm::setInstrumentEnvelopeParameters()
 {
 	Ui::EventGuard eg(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instFM = dynamic_cast<InstrumentFM*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instFM = dynamic_cast<const InstrumentFM*>(inst.get());
 
 	ui->envNumSpinBox->setValue(instFM->getEnvelopeNumber());
 	onEnvelopeNumberChanged();
@@ -1250,8 +1253,8 @@ void InstrumentEditorFMForm::onEnvelopeNumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getEnvelopeFMUsers(ui->envNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getEnvelopeFMUsers(ui->envNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -1263,8 +1266,8 @@ void InstrumentEditorFMForm::setInstrumentLFOParameters()
 {
 	Ui::EventGuard eg(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instFM = dynamic_cast<InstrumentFM*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instFM = dynamic_cast<const InstrumentFM*>(inst.get());
 
 	ui->lfoNumSpinBox->setValue(instFM->getLFONumber());
 	ui->lfoFreqSlider->setValue(instFM->getLFOParameter(FMLFOParameter::FREQ));
@@ -1329,8 +1332,8 @@ void InstrumentEditorFMForm::onLFONumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getLFOFMUsers(ui->lfoNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getLFOFMUsers(ui->lfoNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -1398,10 +1401,11 @@ void InstrumentEditorFMForm::setInstrumentOperatorSequenceParameters()
 {
 	Ui::EventGuard ev(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instFM = dynamic_cast<InstrumentFM*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instFM = dynamic_cast<const InstrumentFM*>(inst.get());
 
 	FMEnvelopeParameter param = getOperatorSequenceParameter();
+	opSeqVersion_ = instFM->getOperatorSequenceVersion(param);
 
 	ui->opSeqNumSpinBox->setValue(instFM->getOperatorSequenceNumber(param));
 	ui->opSeqEditor->clearData();
@@ -1507,8 +1511,8 @@ void InstrumentEditorFMForm::onOperatorSequenceNumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getOperatorSequenceFMUsers(getOperatorSequenceParameter(), ui->opSeqNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getOperatorSequenceFMUsers(getOperatorSequenceParameter(), ui->opSeqNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -1519,6 +1523,9 @@ void InstrumentEditorFMForm::onOperatorSequenceNumberChanged()
 void InstrumentEditorFMForm::onOperatorSequenceParameterChanged(FMEnvelopeParameter param, int tnNum)
 {
 	if (param == getOperatorSequenceParameter() && ui->opSeqNumSpinBox->value() == tnNum) {
+		std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+		if (dynamic_cast<const InstrumentFM*>(inst.get())->getOperatorSequenceVersion(param) == opSeqVersion_) return;
+
 		Ui::EventGuard eg(isIgnoreEvent_);
 		setInstrumentOperatorSequenceParameters();
 	}
@@ -1562,8 +1569,9 @@ void InstrumentEditorFMForm::setInstrumentArpeggioParameters()
 {
 	Ui::EventGuard ev(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instFM = dynamic_cast<InstrumentFM*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instFM = dynamic_cast<const InstrumentFM*>(inst.get());
+	arpVersion_ = instFM->getArpeggioVersion();
 
 	ui->arpNumSpinBox->setValue(instFM->getArpeggioNumber());
 	ui->arpEditor->clearData();
@@ -1590,8 +1598,8 @@ void InstrumentEditorFMForm::onArpeggioNumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getArpeggioFMUsers(ui->arpNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getArpeggioFMUsers(ui->arpNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -1602,6 +1610,9 @@ void InstrumentEditorFMForm::onArpeggioNumberChanged()
 void InstrumentEditorFMForm::onArpeggioParameterChanged(int tnNum)
 {
 	if (ui->arpNumSpinBox->value() == tnNum) {
+		std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+		if (dynamic_cast<const InstrumentFM*>(inst.get())->getArpeggioVersion() == arpVersion_) return;
+
 		Ui::EventGuard eg(isIgnoreEvent_);
 		setInstrumentArpeggioParameters();
 	}
@@ -1666,8 +1677,9 @@ void InstrumentEditorFMForm::setInstrumentPitchParameters()
 {
 	Ui::EventGuard ev(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instFM = dynamic_cast<InstrumentFM*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instFM = dynamic_cast<const InstrumentFM*>(inst.get());
+	ptVersion_ = instFM->getPitchVersion();
 
 	ui->ptNumSpinBox->setValue(instFM->getPitchNumber());
 	ui->ptEditor->clearData();
@@ -1699,8 +1711,8 @@ void InstrumentEditorFMForm::onPitchNumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getPitchFMUsers(ui->ptNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getPitchFMUsers(ui->ptNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -1711,6 +1723,9 @@ void InstrumentEditorFMForm::onPitchNumberChanged()
 void InstrumentEditorFMForm::onPitchParameterChanged(int tnNum)
 {
 	if (ui->ptNumSpinBox->value() == tnNum) {
+		std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+		if (dynamic_cast<const InstrumentFM*>(inst.get())->getPitchVersion() == ptVersion_) return;
+
 		Ui::EventGuard eg(isIgnoreEvent_);
 		setInstrumentPitchParameters();
 	}
@@ -120,6 +120,9 @@ public slots:
 	void onOperatorSequenceParameterChanged(FMEnvelopeParameter param, int opSeqNum);
 
 private:
+	/// Version of the shown sequence. Rebuilding is skipped while it is unchanged
+	uint64_t opSeqVersion_;
+
 	void setInstrumentOperatorSequenceParameters();
 	void setOperatorSequenceEditor();
 
@@ -138,6 +141,8 @@ public slots:
 	void onArpeggioParameterChanged(int arpNum);
 
 private:
+	uint64_t arpVersion_;
+
 	void setInstrumentArpeggioParameters();
 
 private slots:
@@ -155,6 +160,8 @@ public slots:
 	void onPitchParameterChanged(int arpNum);
 
 private:
+	uint64_t ptVersion_;
+
 	void setInstrumentPitchParameters();
 
 private slots:
@@ -8,7 +8,12 @@
 InstrumentEditorSSGForm::InstrumentEditorSSGForm(int num, QWidget *parent) :
 	QWidget(parent),
 	ui(new Ui::InstrumentEditorSSGForm),
-	instNum_(num)
+	instNum_(num),
+	wfVersion_(0),
+	tnVersion_(0),
+	envVersion_(0),
+	arpVersion_(0),
+	ptVersion_(0)
 {
 	ui->setupUi(this);
 
@@ -399,8 +404,8 @@ void InstrumentEditorSSGForm::updateInstrumentParameters()
 {
 	Ui::EventGuard eg(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instSSG = dynamic_cast<InstrumentSSG*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instSSG = dynamic_cast<const InstrumentSSG*>(inst.get());
 	auto name = QString::fromUtf8(instSSG->getName().c_str(), instSSG->getName().length());
 	setWindowTitle(QString("%1: %2").arg(instNum_, 2, 16, QChar('0')).toUpper().arg(name));
 
@@ -529,8 +534,9 @@ void InstrumentEditorSSGForm::setInstrumentWaveFormParameters()
 {
 	Ui::EventGuard ev(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instSSG = dynamic_cast<InstrumentSSG*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instSSG = dynamic_cast<const InstrumentSSG*>(inst.get());
+	wfVersion_ = instSSG->getWaveFormVersion();
 
 	ui->waveNumSpinBox->setValue(instSSG->getWaveFormNumber());
 	ui->waveEditor->clearData();
@@ -574,8 +580,8 @@ void InstrumentEditorSSGForm::onWaveFormNumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getWaveFormSSGUsers(ui->waveNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getWaveFormSSGUsers(ui->waveNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -586,6 +592,9 @@ void InstrumentEditorSSGForm::onWaveFormNumberChanged()
 void InstrumentEditorSSGForm::onWaveFormParameterChanged(int wfNum)
 {
 	if (ui->waveNumSpinBox->value() == wfNum) {
+		std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+		if (dynamic_cast<const InstrumentSSG*>(inst.get())->getWaveFormVersion() == wfVersion_) return;
+
 		Ui::EventGuard eg(isIgnoreEvent_);
 		setInstrumentWaveFormParameters();
 	}
@@ -620,8 +629,9 @@ void InstrumentEditorSSGForm::setInstrumentToneNoiseParameters()
 {
 	Ui::EventGuard ev(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instSSG = dynamic_cast<InstrumentSSG*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instSSG = dynamic_cast<const InstrumentSSG*>(inst.get());
+	tnVersion_ = instSSG->getToneNoiseVersion();
 
 	ui->tnNumSpinBox->setValue(instSSG->getToneNoiseNumber());
 	ui->tnEditor->clearData();
@@ -647,8 +657,8 @@ void InstrumentEditorSSGForm::onToneNoiseNumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getToneNoiseSSGUsers(ui->tnNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getToneNoiseSSGUsers(ui->tnNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -659,6 +669,9 @@ void InstrumentEditorSSGForm::onToneNoiseNumberChanged()
 void InstrumentEditorSSGForm::onToneNoiseParameterChanged(int tnNum)
 {
 	if (ui->tnNumSpinBox->value() == tnNum) {
+		std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+		if (dynamic_cast<const InstrumentSSG*>(inst.get())->getToneNoiseVersion() == tnVersion_) return;
+
 		Ui::EventGuard eg(isIgnoreEvent_);
 		setInstrumentToneNoiseParameters();
 	}
@@ -693,8 +706,9 @@ void InstrumentEditorSSGForm::setInstrumentEnvelopeParameters()
 {
 	Ui::EventGuard ev(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instSSG = dynamic_cast<InstrumentSSG*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instSSG = dynamic_cast<const InstrumentSSG*>(inst.get());
+	envVersion_ = instSSG->getEnvelopeVersion();
 
 	ui->envNumSpinBox->setValue(instSSG->getEnvelopeNumber());
 	ui->envEditor->clearData();
@@ -724,8 +738,8 @@ void InstrumentEditorSSGForm::onEnvelopeNumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getEnvelopeSSGUsers(ui->envNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getEnvelopeSSGUsers(ui->envNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -736,6 +750,9 @@ void InstrumentEditorSSGForm::onEnvelopeNumberChanged()
 void InstrumentEditorSSGForm::onEnvelopeParameterChanged(int envNum)
 {
 	if (ui->envNumSpinBox->value() == envNum) {
+		std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+		if (dynamic_cast<const InstrumentSSG*>(inst.get())->getEnvelopeVersion() == envVersion_) return;
+
 		Ui::EventGuard eg(isIgnoreEvent_);
 		setInstrumentEnvelopeParameters();
 	}
@@ -778,8 +795,9 @@ void InstrumentEditorSSGForm::setInstrumentArpeggioParameters()
 {
 	Ui::EventGuard ev(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instSSG = dynamic_cast<InstrumentSSG*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instSSG = dynamic_cast<const InstrumentSSG*>(inst.get());
+	arpVersion_ = instSSG->getArpeggioVersion();
 
 	ui->arpNumSpinBox->setValue(instSSG->getArpeggioNumber());
 	ui->arpEditor->clearData();
@@ -806,8 +824,8 @@ void InstrumentEditorSSGForm::onArpeggioNumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getArpeggioSSGUsers(ui->arpNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getArpeggioSSGUsers(ui->arpNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -818,6 +836,9 @@ void InstrumentEditorSSGForm::onArpeggioNumberChanged()
 void InstrumentEditorSSGForm::onArpeggioParameterChanged(int tnNum)
 {
 	if (ui->arpNumSpinBox->value() == tnNum) {
+		std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+		if (dynamic_cast<const InstrumentSSG*>(inst.get())->getArpeggioVersion() == arpVersion_) return;
+
 		Ui::EventGuard eg(isIgnoreEvent_);
 		setInstrumentArpeggioParameters();
 	}
@@ -882,8 +903,9 @@ void InstrumentEditorSSGForm::setInstrumentPitchParameters()
 {
 	Ui::EventGuard ev(isIgnoreEvent_);
 
-	std::unique_ptr<AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
-	auto instSSG = dynamic_cast<InstrumentSSG*>(inst.get());
+	std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+	auto instSSG = dynamic_cast<const InstrumentSSG*>(inst.get());
+	ptVersion_ = instSSG->getPitchVersion();
 
 	ui->ptNumSpinBox->setValue(instSSG->getPitchNumber());
 	ui->ptEditor->clearData();
@@ -915,8 +937,8 @@ void InstrumentEditorSSGForm::onPitchNumberChanged()
 {
 	// Change users view
 	QString str;
-	std::vector<int> users = bt_.lock()->getPitchSSGUsers(ui->ptNumSpinBox->value());
-	for (auto& n : users) {
+	InstrumentUserSet users = bt_.lock()->getPitchSSGUsers(ui->ptNumSpinBox->value());
+	for (int n : users) {
 		str += (QString("%1").arg(n, 2, 16, QChar('0')).toUpper() + ",");
 	}
 	str.chop(1);
@@ -927,6 +949,9 @@ void InstrumentEditorSSGForm::onPitchNumberChanged()
 void InstrumentEditorSSGForm::onPitchParameterChanged(int tnNum)
 {
 	if (ui->ptNumSpinBox->value() == tnNum) {
+		std::shared_ptr<const AbstractInstrument> inst = bt_.lock()->getInstrument(instNum_);
+		if (dynamic_cast<const InstrumentSSG*>(inst.get())->getPitchVersion() == ptVersion_) return;
+
 		Ui::EventGuard eg(isIgnoreEvent_);
 		setInstrumentPitchParameters();
 	}
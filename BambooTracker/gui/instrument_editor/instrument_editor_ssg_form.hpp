@@ -65,6 +65,9 @@ public slots:
 	void onWaveFormParameterChanged(int wfNum);
 
 private:
+	/// Version of the shown sequence. Rebuilding is skipped while it is unchanged
+	uint64_t wfVersion_;
+
 	void setInstrumentWaveFormParameters();
 
 private slots:
@@ -81,6 +84,8 @@ public slots:
 	void onToneNoiseParameterChanged(int tnNum);
 
 private:
+	uint64_t tnVersion_;
+
 	void setInstrumentToneNoiseParameters();
 
 private slots:
@@ -97,6 +102,8 @@ public slots:
 	void onEnvelopeParameterChanged(int envNum);
 
 private:
+	uint64_t envVersion_;
+
 	void setInstrumentEnvelopeParameters();
 
 private slots:
@@ -114,6 +121,8 @@ public slots:
 	void onArpeggioParameterChanged(int arpNum);
 
 private:
+	uint64_t arpVersion_;
+
 	void setInstrumentArpeggioParameters();
 
 private slots:
@@ -131,6 +140,8 @@ public slots:
 	void onPitchParameterChanged(int arpNum);
 
 private:
+	uint64_t ptVersion_;
+
 	void setInstrumentPitchParameters();
 
 private slots:
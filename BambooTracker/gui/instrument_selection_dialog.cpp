@@ -26,6 +26,14 @@ void InstrumentSelectionDialog::setupContents()
 		item->setData(Qt::UserRole, (qulonglong)i);
 		lw->addItem(item);
 	}
+
+	// Filter on the names of the bank index without decoding instruments
+	QObject::connect(ui_->searchLineEdit, &QLineEdit::textChanged, this, [lw](const QString& text) {
+		for (int i = 0; i < lw->count(); ++i) {
+			QListWidgetItem *item = lw->item(i);
+			item->setHidden(!item->text().contains(text, Qt::CaseInsensitive));
+		}
+	});
 }
 
 QVector<size_t> InstrumentSelectionDialog::currentInstrumentSelection() const
@@ -12,6 +12,7 @@
 #include <QFileInfo>
 #include <QMimeData>
 #include <QProgressDialog>
+#include <QEventLoop>
 #include <QRect>
 #include <QDesktopWidget>
 #include <QAudioDeviceInfo>
@@ -34,6 +35,7 @@
 #include "gui/instrument_selection_dialog.hpp"
 #include "gui/s98_export_settings_dialog.hpp"
 #include "gui/configuration_handler.hpp"
+#include "gui/clipboard_format.hpp"
 #include "chips/scci/SCCIDefines.h"
 
 MainWindow::MainWindow(QString filePath, QWidget *parent) :
@@ -73,7 +75,7 @@ MainWindow::MainWindow(QString filePath, QWidget *parent) :
 	QObject::connect(comStack_.get(), &QUndoStack::indexChanged,
 					 this, [&](int idx) {
 		setWindowModified(idx || isModifiedForNotCommand_);
-		ui->actionUndo->setEnabled(comStack_->canUndo());
+		ui->actionUndo->setEnabled(comStack_->canUndo() && bt_->canUndo());
 		ui->actionRedo->setEnabled(comStack_->canRedo());
 	});
 
@@ -578,10 +580,10 @@ void MainWindow::dropEvent(QDropEvent* event)
 	lockControls(false);
 
 	try {
-		bt_->loadModule(event->mimeData()->urls().first().toLocalFile().toLocal8Bit().toStdString());
-		loadModule();
-		isModifiedForNotCommand_ = false;
-		setWindowModified(false);
+		if (loadModuleFile(event->mimeData()->urls().first().toLocalFile())) {
+			isModifiedForNotCommand_ = false;
+			setWindowModified(false);
+		}
 	}
 	catch (std::exception& e) {
 		QMessageBox::critical(this, tr("Error"), e.what());
@@ -751,31 +753,51 @@ void MainWindow::deepCloneInstrument()
 void MainWindow::loadInstrument()
 {
 	QString dir = QString::fromStdString(config_->getWorkingDirectory());
-	QString file = QFileDialog::getOpenFileName(this, tr("Open instrument"), (dir.isEmpty() ? "./" : dir),
-												"BambooTracker instrument (*.bti);;"
-												"DefleMask preset (*.dmp);;"
-												"TFM Music Maker instrument (*.tfi);;"
-												"VGM Music Maker instrument (*.vgi);;"
-												"WOPN instrument (*.opni);;"
-												"Gens KMod dump (*.y12);;"
-												"MVSTracker instrument (*.ins)");
-	if (file.isNull()) return;
+	QStringList files = QFileDialog::getOpenFileNames(this, tr("Open instrument"), (dir.isEmpty() ? "./" : dir),
+													  "BambooTracker instrument (*.bti);;"
+													  "DefleMask preset (*.dmp);;"
+													  "TFM Music Maker instrument (*.tfi);;"
+													  "VGM Music Maker instrument (*.vgi);;"
+													  "WOPN instrument (*.opni);;"
+													  "Gens KMod dump (*.y12);;"
+													  "MVSTracker instrument (*.ins)");
+	if (files.isEmpty()) return;
+
+	std::vector<std::string> paths;
+	for (auto& file : files) paths.push_back(file.toLocal8Bit().toStdString());
+
+	std::vector<int> nums;
+	try {
+		bt_->loadInstruments(paths, nums);
+		addInstrumentItems(nums);
+		config_->setWorkingDirectory(QFileInfo(files.front()).dir().path().toStdString());
+	}
+	catch (std::exception& e) {
+		addInstrumentItems(nums);
+		QMessageBox::critical(this, tr("Error"), e.what());
+		return;
+	}
+	if (nums.size() < paths.size())
+		QMessageBox::critical(this, tr("Error"), tr("Failed to load instrument."));
+}
 
-	int n = bt_->findFirstFreeInstrumentNumber();
-	if (n == -1) QMessageBox::critical(this, tr("Error"), tr("Failed to load instrument."));
+void MainWindow::addInstrumentItems(const std::vector<int>& nums)
+{
+	if (nums.empty()) return;
 
-	try {
-		bt_->loadInstrument(file.toLocal8Bit().toStdString(), n);
+	// Repaint the list once after all instruments are added,
+	// and undo them at once as the core does
+	ui->instrumentListWidget->setUpdatesEnabled(false);
+	comStack_->beginMacro(tr("Add instruments"));
+	for (int n : nums) {
 		auto inst = bt_->getInstrument(n);
 		auto name = inst->getName();
 		comStack_->push(new AddInstrumentQtCommand(ui->instrumentListWidget, n,
 												   QString::fromUtf8(name.c_str(), name.length()),
 												   inst->getSoundSource(), instForms_));
-		config_->setWorkingDirectory(QFileInfo(file).dir().path().toStdString());
-	}
-	catch (std::exception& e) {
-		QMessageBox::critical(this, tr("Error"), e.what());
 	}
+	comStack_->endMacro();
+	ui->instrumentListWidget->setUpdatesEnabled(true);
 }
 
 void MainWindow::saveInstrument()
@@ -818,32 +840,27 @@ void MainWindow::importInstrumentsFromBank()
 		return;
 
 	QVector<size_t> selection = dlg.currentInstrumentSelection();
+	std::vector<size_t> indices(selection.begin(), selection.end());
 
+	std::vector<int> nums;
 	try {
-		for (size_t index : selection) {
-			int n = bt_->findFirstFreeInstrumentNumber();
-			if (n == -1){
-				QMessageBox::critical(this, tr("Error"), tr("Failed to load instrument."));
-				return;
-			}
-
-			bt_->importInstrument(*bank, index, n);
-
-			auto inst = bt_->getInstrument(n);
-			auto name = inst->getName();
-			comStack_->push(new AddInstrumentQtCommand(ui->instrumentListWidget, n,
-													   QString::fromUtf8(name.c_str(), name.length()),
-													   inst->getSoundSource(), instForms_));
-		}
+		bt_->importInstruments(*bank, indices, nums);
+		addInstrumentItems(nums);
 	}
 	catch (std::exception& e) {
+		addInstrumentItems(nums);
 		QMessageBox::critical(this, tr("Error"), e.what());
+		return;
 	}
+	if (nums.size() < indices.size())
+		QMessageBox::critical(this, tr("Error"), tr("Failed to load instrument."));
 }
 
 /********** Undo-Redo **********/
 void MainWindow::undo()
 {
+	// Do nothing when the command has been discarded from the history
+	if (!bt_->canUndo()) return;
 	bt_->undo();
 	comStack_->undo();
 }
@@ -896,6 +913,35 @@ void MainWindow::loadModule()
 	bt_->clearCommandHistory();
 }
 
+/// Return false if loading is canceled
+bool MainWindow::loadModuleFile(QString file)
+{
+	QProgressDialog progress(tr("Loading module"), tr("Cancel"), 0, 100, this);
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setWindowFlags(progress.windowFlags()
+							& ~Qt::WindowContextHelpButtonHint
+							& ~Qt::WindowCloseButtonHint);
+	progress.setValue(0);
+	QObject::connect(&progress, &QProgressDialog::canceled, this, [&] { bt_->cancelLoadingModule(); });
+
+	// Poll the loader until it finishes without blocking the event loop
+	QEventLoop loop;
+	QTimer timer;
+	QObject::connect(&timer, &QTimer::timeout, &loop, [&] {
+		if (bt_->isLoadingModule()) progress.setValue(bt_->getModuleLoadingProgress());
+		else loop.quit();
+	});
+	bt_->startLoadingModule(file.toLocal8Bit().toStdString());
+	timer.start(10);
+	loop.exec();
+	timer.stop();
+	progress.close();
+
+	if (!bt_->finishLoadingModule()) return false;
+	loadModule();
+	return true;
+}
+
 void MainWindow::loadSong()
 {
 	// Init position
@@ -1346,7 +1392,9 @@ void MainWindow::updateMenuByPattern()
 	}
 	else {
 		// Edit
-		bool enabled = QApplication::clipboard()->text().startsWith("PATTERN_");
+		const QMimeData* mime = QApplication::clipboard()->mimeData();
+		bool enabled = (mime && (mime->hasFormat(ClipboardFormat::PATTERN_CELLS)
+								 || mime->text().startsWith("PATTERN_")));
 		ui->actionPaste->setEnabled(enabled);
 		ui->actionMix->setEnabled(enabled);
 		ui->actionOverwrite->setEnabled(enabled);
@@ -1394,7 +1442,9 @@ void MainWindow::updateMenuByOrder()
 	}
 	else {
 		// Edit
-		bool enabled = QApplication::clipboard()->text().startsWith("ORDER_");
+		const QMimeData* mime = QApplication::clipboard()->mimeData();
+		bool enabled = (mime && (mime->hasFormat(ClipboardFormat::ORDER_CELLS)
+								 || mime->text().startsWith("ORDER_")));
 		ui->actionPaste->setEnabled(enabled);
 		ui->actionDelete->setEnabled(true);
 		// Song
@@ -1752,7 +1802,7 @@ bool MainWindow::on_actionSave_triggered()
 		}
 
 		try {
-			bt_->saveModule(bt_->getModulePath());
+			bt_->saveModule(bt_->getModulePath(), config_->getCompressModules());
 			isModifiedForNotCommand_ = false;
 			isSavedModBefore_ = true;
 			setWindowModified(false);
@@ -1791,7 +1841,7 @@ bool MainWindow::on_actionSave_As_triggered()
 
 	bt_->setModulePath(file.toLocal8Bit().toStdString());
 	try {
-		bt_->saveModule(bt_->getModulePath());
+		bt_->saveModule(bt_->getModulePath(), config_->getCompressModules());
 		isModifiedForNotCommand_ = false;
 		isSavedModBefore_ = true;
 		setWindowModified(false);
@@ -1836,12 +1886,11 @@ void MainWindow::on_actionOpen_triggered()
 	bt_->stopPlaySong();
 	lockControls(false);
 	try {
-		bt_->loadModule(file.toLocal8Bit().toStdString());
-		loadModule();
-
-		config_->setWorkingDirectory(QFileInfo(file).dir().path().toStdString());
-		isModifiedForNotCommand_ = false;
-		setWindowModified(false);
+		if (loadModuleFile(file)) {
+			config_->setWorkingDirectory(QFileInfo(file).dir().path().toStdString());
+			isModifiedForNotCommand_ = false;
+			setWindowModified(false);
+		}
 	}
 	catch (std::exception& e) {
 		QMessageBox::critical(this, tr("Error"), e.what());
@@ -73,6 +73,7 @@ private:
 	void loadInstrument();
 	void saveInstrument();
 	void importInstrumentsFromBank();
+	void addInstrumentItems(const std::vector<int>& nums);
 
 	// Undo-Redo
 	void undo();
@@ -82,6 +83,7 @@ private:
 	// Load data
 	void loadModule();
 	void loadSong();
+	bool loadModuleFile(QString file);
 
 	// Play song
 	void startPlaySong();
@@ -3,6 +3,10 @@
 #include <QFontMetrics>
 #include <QApplication>
 #include <QClipboard>
+#include <QMimeData>
+#include <QByteArray>
+#include <QDataStream>
+#include <QStringList>
 #include <QMenu>
 #include <QAction>
 #include <QFontMetrics>
@@ -14,6 +18,7 @@
 #include <vector>
 #include <utility>
 #include "gui/event_guard.hpp"
+#include "gui/clipboard_format.hpp"
 #include "gui/command/order/order_commands.hpp"
 #include "track.hpp"
 
@@ -452,43 +457,75 @@ void OrderListPanel::copySelectedCells()
 	int w = selRightBelowPos_.track - selLeftAbovePos_.track + 1;
 	int h = selRightBelowPos_.row - selLeftAbovePos_.row + 1;
 
-	QString str = QString("ORDER_COPY:%1,%2,")
-				  .arg(QString::number(w), QString::number(h));
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream << static_cast<qint32>(w) << static_cast<qint32>(h);
+
+	QStringList list;
+	list.reserve(w * h);
 	for (int i = 0; i < h; ++i) {
 		std::vector<OrderData> odrs = bt_->getOrderData(curSongNum_, selLeftAbovePos_.row + i);
 		for (int j = 0; j < w; ++j) {
-			str += QString::number(odrs.at(selLeftAbovePos_.track + j).patten);
-			if (i < h - 1 || j < w - 1) str += ",";
+			int ptn = odrs.at(selLeftAbovePos_.track + j).patten;
+			stream << static_cast<qint32>(ptn);
+			list << QString::number(ptn);
 		}
 	}
 
-	QApplication::clipboard()->setText(str);
+	auto mime = new QMimeData();
+	mime->setData(ClipboardFormat::ORDER_CELLS, data);
+	mime->setText(QString("ORDER_COPY:%1,%2,").arg(QString::number(w), QString::number(h)) + list.join(","));
+	QApplication::clipboard()->setMimeData(mime);
 }
 
 void OrderListPanel::pasteCopiedCells(const OrderPosition& startPos)
 {
-	// Analyze text
-	QString str = QApplication::clipboard()->text().remove(QRegularExpression("ORDER_COPY:"));
-	QString hdRe = "^([0-9]+),([0-9]+),";
-	QRegularExpression re(hdRe);
-	QRegularExpressionMatch match = re.match(str);
-	int w = match.captured(1).toInt();
-	int h = match.captured(2).toInt();
-	str.remove(re);
-
-	std::vector<std::vector<std::string>> cells;
-	re = QRegularExpression("^([^,]+),");
-	for (int i = 0; i < h; ++i) {
-		cells.emplace_back();
-		for (int j = 0; j < w; ++j) {
-			match = re.match(str);
-			if (match.hasMatch()) {
-				cells.at(i).push_back(match.captured(1).toStdString());
-				str.remove(re);
+	const QMimeData* mime = QApplication::clipboard()->mimeData();
+	if (!mime) return;
+
+	// Order count and pattern numbers are stored in a byte.
+	// Reject sizes and numbers which cannot be in the song before allocating
+	constexpr int MAX_ORDER_CNT = 256;
+	constexpr int MAX_PATTERN_NUM = 255;
+	const int trackCnt = static_cast<int>(songStyle_.trackAttribs.size());
+	auto isValidSize = [&](int w, int h) {
+		return (0 < w && w <= trackCnt && 0 < h && h <= MAX_ORDER_CNT);
+	};
+	auto isValidPattern = [&](int ptn) { return (0 <= ptn && ptn <= MAX_PATTERN_NUM); };
+
+	std::vector<std::vector<int>> cells;
+	if (mime->hasFormat(ClipboardFormat::ORDER_CELLS)) {
+		// Binary form set in this application
+		QByteArray data = mime->data(ClipboardFormat::ORDER_CELLS);
+		QDataStream stream(&data, QIODevice::ReadOnly);
+		qint32 w, h;
+		stream >> w >> h;
+		if (stream.status() != QDataStream::Ok || !isValidSize(w, h)) return;
+		cells.assign(static_cast<size_t>(h), std::vector<int>(static_cast<size_t>(w)));
+		for (auto& row : cells) {
+			for (auto& cell : row) {
+				qint32 ptn;
+				stream >> ptn;
+				if (!isValidPattern(ptn)) return;
+				cell = ptn;
 			}
-			else {
-				cells.at(i).push_back(str.toStdString());
-				break;
+		}
+		if (stream.status() != QDataStream::Ok) return;
+	}
+	else {
+		// Analyze text
+		QStringList list = mime->text().remove(QRegularExpression("^ORDER_COPY:")).split(",");
+		if (list.size() < 2) return;
+		int w = list.at(0).toInt();
+		int h = list.at(1).toInt();
+		if (!isValidSize(w, h) || list.size() < 2 + w * h) return;
+		cells.assign(static_cast<size_t>(h), std::vector<int>(static_cast<size_t>(w)));
+		int n = 2;
+		for (auto& row : cells) {
+			for (auto& cell : row) {
+				bool ok;
+				cell = list.at(n++).toInt(&ok);
+				if (!ok || !isValidPattern(cell)) return;
 			}
 		}
 	}
@@ -593,8 +630,8 @@ void OrderListPanel::showContextMenu(const OrderPosition& pos, const QPoint& poi
 			copy->setEnabled(false);
 			paste->setEnabled(false);
 		}
-		QString clipText = QApplication::clipboard()->text();
-		if (!clipText.startsWith("ORDER_COPY")) {
+		const QMimeData* mime = QApplication::clipboard()->mimeData();
+		if (!mime || (!mime->hasFormat(ClipboardFormat::ORDER_CELLS) && !mime->text().startsWith("ORDER_COPY"))) {
 				paste->setEnabled(false);
 		}
 		if (bt_->getOrderSize(curSongNum_) == 1) {
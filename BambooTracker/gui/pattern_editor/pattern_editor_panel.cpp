@@ -4,6 +4,10 @@
 #include <QPoint>
 #include <QApplication>
 #include <QClipboard>
+#include <QMimeData>
+#include <QByteArray>
+#include <QDataStream>
+#include <QStringList>
 #include <QMenu>
 #include <QAction>
 #include <QRegularExpression>
@@ -12,6 +16,7 @@
 #include <vector>
 #include <utility>
 #include "gui/event_guard.hpp"
+#include "gui/clipboard_format.hpp"
 #include "gui/command/pattern/pattern_commands_qt.hpp"
 
 PatternEditorPanel::PatternEditorPanel(QWidget *parent)
@@ -327,7 +332,7 @@ int PatternEditorPanel::drawStep(QPainter &painter, int trackNum, int orderNum,
 		painter.drawText(offset, baseY, "--");
 	}
 	else {
-		std::unique_ptr<AbstractInstrument> inst = bt_->getInstrument(instNum);
+		std::shared_ptr<const AbstractInstrument> inst = bt_->getInstrument(instNum);
 		painter.setPen((inst != nullptr && src == inst->getSoundSource())
 					   ? palette_.lock()->ptnInstColor
 					   : palette_.lock()->ptnErrorColor);
@@ -667,37 +672,8 @@ int PatternEditorPanel::calculateColumnDistance(int beginTrack, int beginColumn,
 
 int PatternEditorPanel::calculateStepDistance(int beginOrder, int beginStep, int endOrder, int endStep) const
 {
-	int d = 0;
-	int startOrder, startStep, stopOrder, stopStep;
-	bool flag;
-
-	if (endOrder >= beginOrder) {
-		startOrder = endOrder;
-		startStep = endStep;
-		stopOrder = beginOrder;
-		stopStep = beginStep;
-		flag = true;
-	}
-	else {
-		startOrder = beginOrder;
-		startStep = beginStep;
-		stopOrder = endOrder;
-		stopStep = endStep;
-		flag = false;
-	}
-
-	while (true) {
-		if (startOrder == stopOrder) {
-			d += (startStep - stopStep);
-			break;
-		}
-		else {
-			d += startStep;
-			startStep = bt_->getPatternSizeFromOrderNumber(curSongNum_, --startOrder);
-		}
-	}
-
-	return flag ? d : -d;
+	return static_cast<int>(bt_->getAbsoluteStepNumber(curSongNum_, endOrder, endStep))
+			- static_cast<int>(bt_->getAbsoluteStepNumber(curSongNum_, beginOrder, beginStep));
 }
 
 QPoint PatternEditorPanel::calculateCurrentCursorPosition() const
@@ -1155,71 +1131,41 @@ void PatternEditorPanel::copySelectedCells()
 {
 	if (selLeftAbovePos_.order == -1) return;
 
+	setSelectedCellsToClipboard(false);
+}
+
+void PatternEditorPanel::setSelectedCellsToClipboard(bool isCut)
+{
 	int w = 1 + calculateColumnDistance(selLeftAbovePos_.track, selLeftAbovePos_.colInTrack,
 										selRightBelowPos_.track, selRightBelowPos_.colInTrack, true);
 	int h = 1 + calculateStepDistance(selLeftAbovePos_.order, selLeftAbovePos_.step,
 									  selRightBelowPos_.order, selRightBelowPos_.step);
-	QString str = QString("PATTERN_COPY:%1,%2,%3,")
-				  .arg(QString::number(selLeftAbovePos_.colInTrack),
-					   QString::number(w),
-					   QString::number(h));
-	PatternPosition pos = selLeftAbovePos_;
-	while (true) {
-		switch (pos.colInTrack) {
-		case 0:
-			str += QString::number(bt_->getStepNoteNumber(curSongNum_, pos.track, pos.order, pos.step));
-			break;
-		case 1:
-			str += QString::number(bt_->getStepInstrument(curSongNum_, pos.track, pos.order, pos.step));
-			break;
-		case 2:
-			str += QString::number(bt_->getStepVolume(curSongNum_, pos.track, pos.order, pos.step));
-			break;
-		case 3:
-			str += QString::fromStdString(bt_->getStepEffectID(curSongNum_, pos.track, pos.order, pos.step, 0));
-			break;
-		case 4:
-			str += QString::number(bt_->getStepEffectValue(curSongNum_, pos.track, pos.order, pos.step, 0));
-			break;
-		case 5:
-			str += QString::fromStdString(bt_->getStepEffectID(curSongNum_, pos.track, pos.order, pos.step, 1));
-			break;
-		case 6:
-			str += QString::number(bt_->getStepEffectValue(curSongNum_, pos.track, pos.order, pos.step, 1));
-			break;
-		case 7:
-			str += QString::fromStdString(bt_->getStepEffectID(curSongNum_, pos.track, pos.order, pos.step, 2));
-			break;
-		case 8:
-			str += QString::number(bt_->getStepEffectValue(curSongNum_, pos.track, pos.order, pos.step, 2));
-			break;
-		case 9:
-			str += QString::fromStdString(bt_->getStepEffectID(curSongNum_, pos.track, pos.order, pos.step, 3));
-			break;
-		case 10:
-			str += QString::number(bt_->getStepEffectValue(curSongNum_, pos.track, pos.order, pos.step, 3));
-			break;
-		}
+	PatternCells cells = bt_->getPatternCells(curSongNum_, selLeftAbovePos_.track, selLeftAbovePos_.colInTrack,
+											  selLeftAbovePos_.order, selLeftAbovePos_.step,
+											  static_cast<size_t>(h), static_cast<size_t>(w));
 
-		if (pos.track == selRightBelowPos_.track && pos.colInTrack == selRightBelowPos_.colInTrack) {
-			if (pos.order == selRightBelowPos_.order && pos.step == selRightBelowPos_.step) {
-				break;
-			}
-			else {
-				pos.setCols(selLeftAbovePos_.track, selLeftAbovePos_.colInTrack);
-				++pos.step;
-			}
-		}
-		else {
-			++pos.colInTrack;
-			pos.track += (pos.colInTrack / 11);
-			pos.colInTrack %= 11;
-		}
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream << static_cast<qint32>(selLeftAbovePos_.colInTrack) << static_cast<qint32>(w) << static_cast<qint32>(h);
 
-		str += ",";
+	QStringList list;
+	list.reserve(w * h + 3);
+	list << QString::number(selLeftAbovePos_.colInTrack) << QString::number(w) << QString::number(h);
+	for (int i = 0; i < h; ++i) {
+		for (int j = 0; j < w; ++j) {
+			int16_t value = cells.getValue(static_cast<size_t>(i), static_cast<size_t>(j));
+			stream << static_cast<qint16>(value);
+			if (PatternCells::isEffectIDColumn((selLeftAbovePos_.colInTrack + j) % PatternCells::COLUMNS_PER_TRACK))
+				list << QString::fromStdString(PatternCells::unpackEffectID(value));
+			else
+				list << QString::number(value);
+		}
 	}
 
-	QApplication::clipboard()->setText(str);
+	auto mime = new QMimeData();
+	mime->setData(ClipboardFormat::PATTERN_CELLS, data);
+	mime->setText((isCut ? "PATTERN_CUT:" : "PATTERN_COPY:") + list.join(",") + ",");
+	QApplication::clipboard()->setMimeData(mime);
 }
 
 void PatternEditorPanel::eraseSelectedCells()
@@ -1233,10 +1179,10 @@ void PatternEditorPanel::eraseSelectedCells()
 void PatternEditorPanel::pasteCopiedCells(const PatternPosition& startPos)
 {
 	int sCol = 0;
-	std::vector<std::vector<std::string>> cells
-			= instantiateCellsFromString(QApplication::clipboard()->text(), sCol);
+	PatternCells cells = instantiateCellsFromClipboard(sCol);
+	if (!cells.getRowCount() || !cells.getColumnCount()) return;
 
-	if (sCol > 2 && !((curPos_.colInTrack - sCol) % 2) && cells.front().size() <= 11 - curPos_.colInTrack)
+	if (sCol > 2 && !((curPos_.colInTrack - sCol) % 2) && cells.getColumnCount() <= 11 - curPos_.colInTrack)
 		sCol = curPos_.colInTrack;
 
 	bt_->pastePatternCells(curSongNum_, startPos.track, sCol,
@@ -1247,10 +1193,10 @@ void PatternEditorPanel::pasteCopiedCells(const PatternPosition& startPos)
 void PatternEditorPanel::pasteMixCopiedCells(const PatternPosition& startPos)
 {
 	int sCol = 0;
-	std::vector<std::vector<std::string>> cells
-			= instantiateCellsFromString(QApplication::clipboard()->text(), sCol);
+	PatternCells cells = instantiateCellsFromClipboard(sCol);
+	if (!cells.getRowCount() || !cells.getColumnCount()) return;
 
-	if (sCol > 2 && !((curPos_.colInTrack - sCol) % 2) && cells.front().size() <= 11 - curPos_.colInTrack)
+	if (sCol > 2 && !((curPos_.colInTrack - sCol) % 2) && cells.getColumnCount() <= 11 - curPos_.colInTrack)
 		sCol = curPos_.colInTrack;
 
 	bt_->pasteMixPatternCells(curSongNum_, startPos.track, sCol,
@@ -1261,10 +1207,10 @@ void PatternEditorPanel::pasteMixCopiedCells(const PatternPosition& startPos)
 void PatternEditorPanel::pasteOverwriteCopiedCells(const PatternPosition& startPos)
 {
 	int sCol = 0;
-	std::vector<std::vector<std::string>> cells
-			= instantiateCellsFromString(QApplication::clipboard()->text(), sCol);
+	PatternCells cells = instantiateCellsFromClipboard(sCol);
+	if (!cells.getRowCount() || !cells.getColumnCount()) return;
 
-	if (sCol > 2 && !((curPos_.colInTrack - sCol) % 2) && cells.front().size() <= 11 - curPos_.colInTrack)
+	if (sCol > 2 && !((curPos_.colInTrack - sCol) % 2) && cells.getColumnCount() <= 11 - curPos_.colInTrack)
 		sCol = curPos_.colInTrack;
 
 	bt_->pasteOverwritePatternCells(curSongNum_, startPos.track, sCol,
@@ -1272,31 +1218,61 @@ void PatternEditorPanel::pasteOverwriteCopiedCells(const PatternPosition& startP
 	comStack_.lock()->push(new PasteOverwriteCopiedDataToPatternQtCommand(this));
 }
 
-std::vector<std::vector<std::string>> PatternEditorPanel::instantiateCellsFromString(QString str, int& startCol)
+PatternCells PatternEditorPanel::instantiateCellsFromClipboard(int& startCol)
 {
-	str.remove(QRegularExpression("PATTERN_(COPY|CUT):"));
-	QString hdRe = "^([0-9]+),([0-9]+),([0-9]+),";
-	QRegularExpression re(hdRe);
-	QRegularExpressionMatch match = re.match(str);
-	startCol = match.captured(1).toInt();
-	int w = match.captured(2).toInt();
-	int h = match.captured(3).toInt();
-	str.remove(re);
+	const QMimeData* mime = QApplication::clipboard()->mimeData();
+	if (!mime) return PatternCells();
 
-	std::vector<std::vector<std::string>> cells;
-	re = QRegularExpression("^([^,]+),");
-	for (int i = 0; i < h; ++i) {
-		cells.emplace_back();
-		for (int j = 0; j < w; ++j) {
-			match = re.match(str);
-			if (match.hasMatch()) {
-				cells.at(i).push_back(match.captured(1).toStdString());
-				str.remove(re);
+	// Reject sizes which cannot fit in the song before allocating
+	auto isValidBlock = [&](int col, int w, int h) {
+		int maxCols = static_cast<int>(songStyle_.trackAttribs.size()) * PatternCells::COLUMNS_PER_TRACK;
+		return (0 <= col && col < PatternCells::COLUMNS_PER_TRACK
+				&& 0 < w && w <= maxCols - col
+				&& 0 < h && static_cast<size_t>(h) <= PatternCells::MAX_ROWS);
+	};
+
+	// Binary form set in this application
+	if (mime->hasFormat(ClipboardFormat::PATTERN_CELLS)) {
+		QByteArray data = mime->data(ClipboardFormat::PATTERN_CELLS);
+		QDataStream stream(&data, QIODevice::ReadOnly);
+		qint32 col, w, h;
+		stream >> col >> w >> h;
+		if (stream.status() != QDataStream::Ok || !isValidBlock(col, w, h)) return PatternCells();
+		startCol = col;
+		PatternCells cells(static_cast<size_t>(h), static_cast<size_t>(w));
+		for (int i = 0; i < h; ++i) {
+			for (int j = 0; j < w; ++j) {
+				qint16 value;
+				stream >> value;
+				cells.setValue(static_cast<size_t>(i), static_cast<size_t>(j), value);
+			}
+		}
+		return (stream.status() == QDataStream::Ok) ? cells : PatternCells();
+	}
+
+	// Text form
+	QString str = mime->text();
+	str.remove(QRegularExpression("^PATTERN_(COPY|CUT):"));
+	QStringList list = str.split(",");
+	if (list.size() < 3) return PatternCells();
+	startCol = list.at(0).toInt();
+	int w = list.at(1).toInt();
+	int h = list.at(2).toInt();
+	if (!isValidBlock(startCol, w, h)) return PatternCells();
+
+	PatternCells cells(static_cast<size_t>(h), static_cast<size_t>(w));
+	int n = 3;
+	for (int i = 0; i < h && n < list.size(); ++i) {
+		for (int j = 0; j < w && n < list.size(); ++j, ++n) {
+			int16_t value;
+			if (PatternCells::isEffectIDColumn((startCol + j) % PatternCells::COLUMNS_PER_TRACK)) {
+				std::string id = list.at(n).toStdString();
+				value = PatternCells::packEffectID(id.size() == 2 ? id : "--");
 			}
 			else {
-				cells.at(i).push_back(str.toStdString());
-				break;
+				value = static_cast<int16_t>(list.at(n).toInt());
 			}
+			cells.setValue(static_cast<size_t>(i), static_cast<size_t>(j), value);
 		}
 	}
 
@@ -1307,11 +1283,8 @@ void PatternEditorPanel::cutSelectedCells()
 {
 	if (selLeftAbovePos_.order == -1) return;
 
-	copySelectedCells();
+	setSelectedCellsToClipboard(true);
 	eraseSelectedCells();
-	QString str = QApplication::clipboard()->text();
-	str.replace("COPY", "CUT");
-	QApplication::clipboard()->setText(str);
 }
 
 void PatternEditorPanel::increaseNoteKey(const PatternPosition& startPos, const PatternPosition& endPos)
@@ -1515,8 +1488,9 @@ void PatternEditorPanel::showPatternContextMenu(const PatternPosition& pos, cons
 		inOct->setEnabled(false);
 	}
 	else {
-		QString clipText = QApplication::clipboard()->text();
-		if (!clipText.startsWith("PATTERN_COPY") && !clipText.startsWith("PATTERN_CUT")) {
+		const QMimeData* mime = QApplication::clipboard()->mimeData();
+		if (!mime || (!mime->hasFormat(ClipboardFormat::PATTERN_CELLS)
+					  && !mime->text().startsWith("PATTERN_COPY") && !mime->text().startsWith("PATTERN_CUT"))) {
 			paste->setEnabled(false);
 			pasteMix->setEnabled(false);
 			pasteOver->setEnabled(false);
@@ -2320,45 +2294,16 @@ bool PatternEditorPanel::mouseHoverd(QHoverEvent *event)
 		hovPos_.setRows(-2, -2);
 	}
 	else {
-		if (pos.y() < curRowY_) {
-			int tmpOdr = curPos_.order;
-			int tmpStep = curPos_.step +  (pos.y() - curRowY_) / stepFontHeight_ - 1;
-			while (true) {
-				if (tmpStep < 0) {
-					if (tmpOdr == 0) {
-						hovPos_.setRows(-1, -1);
-						break;
-					}
-					else {
-						tmpStep += bt_->getPatternSizeFromOrderNumber(curSongNum_, --tmpOdr);
-					}
-				}
-				else {
-					hovPos_.setRows(tmpOdr, tmpStep);
-					break;
-				}
-			}
+		int absStep = static_cast<int>(bt_->getAbsoluteStepNumber(curSongNum_, curPos_.order, curPos_.step));
+		if (pos.y() < curRowY_) absStep += (pos.y() - curRowY_) / stepFontHeight_ - 1;
+		else absStep += (pos.y() - curRowY_) / stepFontHeight_;
+		if (absStep < 0 || static_cast<int>(bt_->getAbsoluteStepNumber(
+												curSongNum_, bt_->getOrderSize(curSongNum_), 0)) <= absStep) {
+			hovPos_.setRows(-1, -1);
 		}
 		else {
-			int tmpOdr = curPos_.order;
-			int tmpStep = curPos_.step +  (pos.y() - curRowY_) / stepFontHeight_;
-			while (true) {
-				int endStep = bt_->getPatternSizeFromOrderNumber(curSongNum_, tmpOdr);
-				if (tmpStep < endStep) {
-					hovPos_.setRows(tmpOdr, tmpStep);
-					break;
-				}
-				else {
-					if (tmpOdr == bt_->getOrderSize(curSongNum_) - 1) {
-						hovPos_.setRows(-1, -1);
-						break;
-					}
-					else {
-						++tmpOdr;
-						tmpStep -= endStep;
-					}
-				}
-			}
+			std::pair<int, int> odrStep = bt_->getPositionFromAbsoluteStepNumber(curSongNum_, absStep);
+			hovPos_.setRows(odrStep.first, odrStep.second);
 		}
 	}
 
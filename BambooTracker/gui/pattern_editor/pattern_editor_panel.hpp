@@ -20,6 +20,7 @@
 #include "bamboo_tracker.hpp"
 #include "configuration.hpp"
 #include "song.hpp"
+#include "pattern_cells.hpp"
 #include "gui/pattern_editor/pattern_position.hpp"
 #include "gui/color_palette.hpp"
 #include "misc.hpp"
@@ -191,7 +192,8 @@ private:
 	void pasteCopiedCells(const PatternPosition& startPos);
 	void pasteMixCopiedCells(const PatternPosition& startPos);
 	void pasteOverwriteCopiedCells(const PatternPosition& startPos);
-	std::vector<std::vector<std::string> > instantiateCellsFromString(QString str, int& startCol);
+	PatternCells instantiateCellsFromClipboard(int& startCol);
+	void setSelectedCellsToClipboard(bool isCut);
 
 	void increaseNoteKey(const PatternPosition& startPos, const PatternPosition& endPos);
 	void decreaseNoteKey(const PatternPosition& startPos, const PatternPosition& endPos);
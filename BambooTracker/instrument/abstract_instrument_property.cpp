@@ -1,8 +1,12 @@
 #include "abstract_instrument_property.hpp"
-#include <algorithm>
+
+std::atomic<uint64_t> AbstractInstrumentProperty::versionCounter_(0);
 
 AbstractInstrumentProperty::AbstractInstrumentProperty(int num)
-	: num_(num)
+	: num_(num),
+	  hash_(0),
+	  isHashCached_(false),
+	  version_(++versionCounter_)
 {
 }
 
@@ -10,6 +14,9 @@ AbstractInstrumentProperty::AbstractInstrumentProperty(const AbstractInstrumentP
 {
 	num_ = other.num_;
 	users_ = other.users_;
+	hash_ = other.hash_;
+	isHashCached_ = other.isHashCached_;
+	version_ = ++versionCounter_;
 }
 
 void AbstractInstrumentProperty::setNumber(int num)
@@ -24,13 +31,12 @@ int AbstractInstrumentProperty::getNumber() const
 
 void AbstractInstrumentProperty::registerUserInstrument(int instNum)
 {
-	users_.push_back(instNum);
-	std::sort(users_.begin(), users_.end());
+	users_.insert(instNum);
 }
 
 void AbstractInstrumentProperty::deregisterUserInstrument(int instNum)
 {
-	users_.erase(std::find(users_.begin(), users_.end(), instNum));
+	users_.erase(instNum);
 }
 
 bool AbstractInstrumentProperty::isUserInstrument() const
@@ -38,7 +44,7 @@ bool AbstractInstrumentProperty::isUserInstrument() const
 	return !users_.empty();
 }
 
-std::vector<int> AbstractInstrumentProperty::getUserInstruments() const
+InstrumentUserSet AbstractInstrumentProperty::getUserInstruments() const
 {
 	return users_;
 }
@@ -47,3 +53,28 @@ void AbstractInstrumentProperty::clearUserInstruments()
 {
 	users_.clear();
 }
+
+size_t AbstractInstrumentProperty::getContentHash() const
+{
+	if (!isHashCached_) {
+		hash_ = calculateContentHash();
+		isHashCached_ = true;
+	}
+	return hash_;
+}
+
+uint64_t AbstractInstrumentProperty::getVersion() const
+{
+	return version_;
+}
+
+void AbstractInstrumentProperty::markContentChanged()
+{
+	isHashCached_ = false;
+	version_ = ++versionCounter_;
+}
+
+size_t AbstractInstrumentProperty::combineHash(size_t seed, int value)
+{
+	return seed ^ (static_cast<size_t>(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <vector>
+#include <atomic>
+#include "instrument_user_set.hpp"
 
 class AbstractInstrumentProperty
 {
@@ -14,14 +17,31 @@ public:
 	void registerUserInstrument(int instNum);
 	void deregisterUserInstrument(int instNum);
 	bool isUserInstrument() const;
-	std::vector<int> getUserInstruments() const;
+	InstrumentUserSet getUserInstruments() const;
 	void clearUserInstruments();
 
+	/// Hash of the contents except the number and users.
+	/// It is cached until the contents are changed.
+	size_t getContentHash() const;
+	/// Number which changes whenever the contents are changed.
+	/// It is unique among all properties, so replacing a property is also detected
+	uint64_t getVersion() const;
+
 protected:
 	explicit AbstractInstrumentProperty(int num);
 	AbstractInstrumentProperty(const AbstractInstrumentProperty& other);
 
+	virtual size_t calculateContentHash() const = 0;
+	/// Drop the cached hash and advance the version
+	void markContentChanged();
+	static size_t combineHash(size_t seed, int value);
+
 private:
 	int num_;
-	std::vector<int> users_;
+	InstrumentUserSet users_;
+	mutable size_t hash_;
+	mutable bool isHashCached_;
+	uint64_t version_;
+
+	static std::atomic<uint64_t> versionCounter_;
 };
@@ -1,44 +1,14 @@
 #include "bank.hpp"
 #include "instrument_io.hpp"
+#include "mapped_file.hpp"
+#include "file_io.hpp"
+#include "file_io_error.hpp"
 #include "format/wopn_file.h"
 #include <stdio.h>
+#include <utility>
 
-void WopnBank::WOPNDeleter::operator()(WOPNFile *x) {
-	WOPN_Free(x);
-}
-
-struct WopnBank::InstEntry {
-	WOPNInstrument *inst;
-	struct {
-		bool percussive : 1;
-		unsigned msb : 7;
-		unsigned lsb : 7;
-		unsigned nth : 7;
-	};
-};
-
-WopnBank::WopnBank(WOPNFile *wopn) : wopn_(wopn) {
-	unsigned numM = wopn->banks_count_melodic;
-	unsigned numP = wopn->banks_count_percussion;
-
-	size_t instMax = 128 * (numP + numM);
-	entries_.reserve(instMax);
-
-	for (size_t i = 0; i < instMax; ++i) {
-		InstEntry ent;
-		ent.percussive = (i / 128) >= numM;
-		WOPNBank &bank = ent.percussive ?
-			wopn->banks_percussive[(i / 128) - numM] :
-			wopn->banks_melodic[i / 128];
-		ent.msb = bank.bank_midi_msb;
-		ent.lsb = bank.bank_midi_lsb;
-		ent.nth = i % 128;
-		ent.inst = &bank.ins[ent.nth];
-		if ((ent.inst->inst_flags & WOPN_Ins_IsBlank) == 0)
-			entries_.push_back(ent);
-	}
-
-	entries_.shrink_to_fit();
+WopnBank::WopnBank(std::shared_ptr<MappedFile> file, uint16_t version, std::vector<InstEntry> entries)
+	: file_(file), version_(version), entries_(std::move(entries)) {
 }
 
 WopnBank::~WopnBank() {
@@ -57,10 +27,27 @@ std::string WopnBank::getInstrumentIdentifier(size_t index) const {
 
 std::string WopnBank::getInstrumentName(size_t index) const {
 	const InstEntry &ent = entries_.at(index);
-	return ent.inst->inst_name;
+	return ent.name;
 }
 
 AbstractInstrument* WopnBank::loadInstrument(size_t index, std::weak_ptr<InstrumentsManager> instMan, int instNum) const {
 	const InstEntry &ent = entries_.at(index);
-	return InstrumentIO::loadWOPNInstrument(*ent.inst, instMan, instNum);
+	WOPNInstrument inst;
+	if (ent.offset > file_->size()
+			|| WOPN_LoadBankInstFromMem(&inst, const_cast<char*>(file_->data() + ent.offset),
+										file_->size() - ent.offset, version_))
+		throw FileCorruptionError(FileIO::FileType::BANK);
+	return InstrumentIO::loadWOPNInstrument(inst, instMan, instNum);
+}
+
+uint64_t WopnBank::getInstrumentHash(size_t index) const {
+	return entries_.at(index).hash;
+}
+
+uint16_t WopnBank::getVersion() const {
+	return version_;
+}
+
+const std::vector<WopnBank::InstEntry>& WopnBank::getEntries() const {
+	return entries_;
 }
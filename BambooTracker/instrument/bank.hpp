@@ -1,11 +1,13 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 class AbstractInstrument;
 class InstrumentsManager;
-struct WOPNFile;
+class MappedFile;
 
 class AbstractBank
 {
@@ -21,7 +23,16 @@ public:
 class WopnBank : public AbstractBank
 {
 public:
-	explicit WopnBank(WOPNFile *wopn);
+	/// Index entry of an instrument, which is decoded from the bank file only when it is loaded
+	struct InstEntry {
+		bool percussive;
+		uint8_t msb, lsb, nth;
+		size_t offset;	// Offset of the instrument data in the bank file
+		uint64_t hash;	// Hash of FM parameters
+		std::string name;
+	};
+
+	WopnBank(std::shared_ptr<MappedFile> file, uint16_t version, std::vector<InstEntry> entries);
 	~WopnBank();
 
 	size_t getNumInstruments() const override;
@@ -29,12 +40,13 @@ public:
 	std::string getInstrumentName(size_t index) const override;
 	AbstractInstrument* loadInstrument(size_t index, std::weak_ptr<InstrumentsManager> instMan, int instNum) const override;
 
-private:
-	struct WOPNDeleter {
-		void operator()(WOPNFile *x);
-	};
-	std::unique_ptr<WOPNFile, WOPNDeleter> wopn_;
+	/// Same hash means the same FM parameters
+	uint64_t getInstrumentHash(size_t index) const;
+	uint16_t getVersion() const;
+	const std::vector<InstEntry>& getEntries() const;
 
-	struct InstEntry;
+private:
+	std::shared_ptr<MappedFile> file_;
+	uint16_t version_;
 	std::vector<InstEntry> entries_;
 };
@@ -2,6 +2,7 @@
 
 CommandSequence::CommandSequence(int num, int seqType, int comType, int comData)
 	: AbstractInstrumentProperty(num),
+	  DEF_SEQ_TYPE(seqType),
 	  DEF_COM_TYPE(comType),
 	  DEF_COM_DATA(comData),
 	  type_(seqType),
@@ -12,8 +13,10 @@ CommandSequence::CommandSequence(int num, int seqType, int comType, int comData)
 
 CommandSequence::CommandSequence(const CommandSequence& other)
 	: AbstractInstrumentProperty(other),
+	  DEF_SEQ_TYPE(other.DEF_SEQ_TYPE),
 	  DEF_COM_TYPE(other.DEF_COM_TYPE),
 	  DEF_COM_DATA(other.DEF_COM_DATA),
+	  type_(other.type_),
 	  seq_(other.seq_),
 	  loops_(other.loops_),
 	  release_(other.release_)
@@ -30,6 +33,7 @@ std::unique_ptr<CommandSequence> CommandSequence::clone()
 void CommandSequence::setType(int type)
 {
 	type_ = type;
+	markContentChanged();
 }
 
 int CommandSequence::getType() const
@@ -52,7 +56,7 @@ int CommandSequence::getSequenceDataAt(int n)
 	return seq_.at(n).data;
 }
 
-std::vector<CommandInSequence> CommandSequence::getSequence() const
+const std::vector<CommandInSequence>& CommandSequence::getSequence() const
 {
 	return seq_;
 }
@@ -60,6 +64,7 @@ std::vector<CommandInSequence> CommandSequence::getSequence() const
 void CommandSequence::addSequenceCommand(int type, int data)
 {
 	seq_.push_back({ type, data });
+	markContentChanged();
 }
 
 void CommandSequence::removeSequenceCommand()
@@ -79,11 +84,14 @@ void CommandSequence::removeSequenceCommand()
 	// Modify release
 	if (release_.begin == seq_.size())
 		release_.begin = -1;
+
+	markContentChanged();
 }
 
 void CommandSequence::setSequenceCommand(int n, int type, int data)
 {
 	seq_.at(n) = { type, data };
+	markContentChanged();
 }
 
 size_t CommandSequence::getNumberOfLoops() const
@@ -106,7 +114,7 @@ int CommandSequence::getTimesOfLoop(int n)
 	return loops_.at(n).times;
 }
 
-std::vector<Loop> CommandSequence::getLoops() const
+const std::vector<Loop>& CommandSequence::getLoops() const
 {
 	return loops_;
 }
@@ -117,6 +125,7 @@ void CommandSequence::setLoops(std::vector<int> begins, std::vector<int> ends, s
 	for (size_t i = 0; i < begins.size(); ++i) {
 		loops_.push_back({ begins.at(i), ends.at(i), times.at(i) });
 	}
+	markContentChanged();
 }
 
 int CommandSequence::getReleaseBeginningCount() const
@@ -137,6 +146,7 @@ Release CommandSequence::getRelease() const
 void CommandSequence::setRelease(ReleaseType type, int begin)
 {
 	release_ = { type, begin };
+	markContentChanged();
 }
 
 std::unique_ptr<CommandSequence::Iterator> CommandSequence::getIterator()
@@ -146,11 +156,50 @@ std::unique_ptr<CommandSequence::Iterator> CommandSequence::getIterator()
 
 bool CommandSequence::isEdited() const
 {
-	return  (seq_.size() != 1 || seq_.front().type != DEF_COM_TYPE || seq_.front().data != DEF_COM_DATA
-			|| loops_.size() || release_.begin > -1);
+	return  (type_ != DEF_SEQ_TYPE
+			|| seq_.size() != 1 || seq_.front().type != DEF_COM_TYPE || seq_.front().data != DEF_COM_DATA
+			|| loops_.size() || release_.type != ReleaseType::NO_RELEASE || release_.begin > -1);
 }
 
 /****************************************/
+bool CommandSequence::hasSameContent(const CommandSequence& other) const
+{
+	if (getContentHash() != other.getContentHash()) return false;
+	if (type_ != other.type_
+			|| seq_.size() != other.seq_.size()
+			|| loops_.size() != other.loops_.size()
+			|| release_.type != other.release_.type
+			|| release_.begin != other.release_.begin)
+		return false;
+	for (size_t i = 0; i < seq_.size(); ++i) {
+		if (seq_[i].type != other.seq_[i].type || seq_[i].data != other.seq_[i].data)
+			return false;
+	}
+	for (size_t i = 0; i < loops_.size(); ++i) {
+		if (loops_[i].begin != other.loops_[i].begin
+				|| loops_[i].end != other.loops_[i].end
+				|| loops_[i].times != other.loops_[i].times)
+			return false;
+	}
+	return true;
+}
+
+size_t CommandSequence::calculateContentHash() const
+{
+	size_t h = combineHash(0, type_);
+	for (auto& com : seq_) {
+		h = combineHash(h, com.type);
+		h = combineHash(h, com.data);
+	}
+	for (auto& loop : loops_) {
+		h = combineHash(h, loop.begin);
+		h = combineHash(h, loop.end);
+		h = combineHash(h, loop.times);
+	}
+	h = combineHash(h, release_.type);
+	return combineHash(h, release_.begin);
+}
+
 CommandSequence::Iterator::Iterator(CommandSequence* seq)
 	: seq_(seq),
 	  pos_(0),
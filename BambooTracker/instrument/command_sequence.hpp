@@ -45,7 +45,8 @@ public:
 	size_t getSequenceSize() const;
 	int getSequenceTypeAt(int n);
 	int getSequenceDataAt(int n);
-	std::vector<CommandInSequence> getSequence() const;
+	/// The reference is valid until the sequence is changed
+	const std::vector<CommandInSequence>& getSequence() const;
 	void addSequenceCommand(int type, int data);
 	void removeSequenceCommand();
 	void setSequenceCommand(int n, int type, int data);
@@ -54,7 +55,7 @@ public:
 	int getBeginningCountOfLoop(int n);
 	int getEndCountOfLoop(int n);
 	int getTimesOfLoop(int n);
-	std::vector<Loop> getLoops() const;
+	const std::vector<Loop>& getLoops() const;
 	void setLoops(std::vector<int> begins, std::vector<int> ends, std::vector<int> times);
 
 	int getReleaseBeginningCount() const;
@@ -84,8 +85,13 @@ public:
 	std::unique_ptr<CommandSequence::Iterator> getIterator();
 
 	bool isEdited() const;
+	bool hasSameContent(const CommandSequence& other) const;
+
+protected:
+	size_t calculateContentHash() const override;
 
 private:
+	const int DEF_SEQ_TYPE;
 	const int DEF_COM_TYPE;
 	const int DEF_COM_DATA;
 
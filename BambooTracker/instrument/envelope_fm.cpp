@@ -90,6 +90,7 @@ bool EnvelopeFM::getOperatorEnabled(int num) const
 void EnvelopeFM::setOperatorEnabled(int num, bool enabled)
 {
 	op_[num].enabled_ = enabled;
+	markContentChanged();
 }
 
 int EnvelopeFM::getParameterValue(FMEnvelopeParameter param) const
@@ -100,6 +101,7 @@ int EnvelopeFM::getParameterValue(FMEnvelopeParameter param) const
 void EnvelopeFM::setParameterValue(FMEnvelopeParameter param, int value)
 {
 	paramMap_.at(param) = value;
+	markContentChanged();
 }
 
 bool EnvelopeFM::isEdited() const
@@ -120,3 +122,44 @@ bool EnvelopeFM::isEdited() const
 	}
 	return false;
 }
+
+bool EnvelopeFM::hasSameContent(const EnvelopeFM& other) const
+{
+	if (getContentHash() != other.getContentHash()) return false;
+	if (al_ != other.al_ || fb_ != other.fb_) return false;
+	for (int i = 0; i < 4; ++i) {
+		if (op_[i].enabled_ != other.op_[i].enabled_
+				|| op_[i].ar_ != other.op_[i].ar_
+				|| op_[i].dr_ != other.op_[i].dr_
+				|| op_[i].sr_ != other.op_[i].sr_
+				|| op_[i].rr_ != other.op_[i].rr_
+				|| op_[i].sl_ != other.op_[i].sl_
+				|| op_[i].tl_ != other.op_[i].tl_
+				|| op_[i].ks_ != other.op_[i].ks_
+				|| op_[i].ml_ != other.op_[i].ml_
+				|| op_[i].dt_ != other.op_[i].dt_
+				|| op_[i].ssgeg_ != other.op_[i].ssgeg_)
+			return false;
+	}
+	return true;
+}
+
+size_t EnvelopeFM::calculateContentHash() const
+{
+	size_t h = combineHash(0, al_);
+	h = combineHash(h, fb_);
+	for (int i = 0; i < 4; ++i) {
+		h = combineHash(h, op_[i].enabled_);
+		h = combineHash(h, op_[i].ar_);
+		h = combineHash(h, op_[i].dr_);
+		h = combineHash(h, op_[i].sr_);
+		h = combineHash(h, op_[i].rr_);
+		h = combineHash(h, op_[i].sl_);
+		h = combineHash(h, op_[i].tl_);
+		h = combineHash(h, op_[i].ks_);
+		h = combineHash(h, op_[i].ml_);
+		h = combineHash(h, op_[i].dt_);
+		h = combineHash(h, op_[i].ssgeg_);
+	}
+	return h;
+}
@@ -21,6 +21,10 @@ public:
 	void setParameterValue(FMEnvelopeParameter param, int value);
 
 	bool isEdited() const;
+	bool hasSameContent(const EnvelopeFM& other) const;
+
+protected:
+	size_t calculateContentHash() const override;
 
 private:
 	int al_;
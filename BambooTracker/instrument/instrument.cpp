@@ -226,12 +226,12 @@ int InstrumentFM::getOperatorSequenceNumber(FMEnvelopeParameter param) const
 	return opSeqNum_.at(param);
 }
 
-std::vector<CommandInSequence> InstrumentFM::getOperatorSequenceSequence(FMEnvelopeParameter param) const
+const std::vector<CommandInSequence>& InstrumentFM::getOperatorSequenceSequence(FMEnvelopeParameter param) const
 {
 	return owner_->getOperatorSequenceFMSequence(param, opSeqNum_.at(param));
 }
 
-std::vector<Loop> InstrumentFM::getOperatorSequenceLoops(FMEnvelopeParameter param) const
+const std::vector<Loop>& InstrumentFM::getOperatorSequenceLoops(FMEnvelopeParameter param) const
 {
 	return owner_->getOperatorSequenceFMLoops(param, opSeqNum_.at(param));
 }
@@ -241,6 +241,11 @@ Release InstrumentFM::getOperatorSequenceRelease(FMEnvelopeParameter param) cons
 	return owner_->getOperatorSequenceFMRelease(param, opSeqNum_.at(param));
 }
 
+uint64_t InstrumentFM::getOperatorSequenceVersion(FMEnvelopeParameter param) const
+{
+	return owner_->getOperatorSequenceFMVersion(param, opSeqNum_.at(param));
+}
+
 std::unique_ptr<CommandSequence::Iterator> InstrumentFM::getOperatorSequenceSequenceIterator(FMEnvelopeParameter param) const
 {
 	return owner_->getOperatorSequenceFMIterator(param, opSeqNum_.at(param));
@@ -271,12 +276,12 @@ int InstrumentFM::getArpeggioType() const
 	return owner_->getArpeggioFMType(arpNum_);
 }
 
-std::vector<CommandInSequence> InstrumentFM::getArpeggioSequence() const
+const std::vector<CommandInSequence>& InstrumentFM::getArpeggioSequence() const
 {
 	return owner_->getArpeggioFMSequence(arpNum_);
 }
 
-std::vector<Loop> InstrumentFM::getArpeggioLoops() const
+const std::vector<Loop>& InstrumentFM::getArpeggioLoops() const
 {
 	return owner_->getArpeggioFMLoops(arpNum_);
 }
@@ -286,6 +291,11 @@ Release InstrumentFM::getArpeggioRelease() const
 	return owner_->getArpeggioFMRelease(arpNum_);
 }
 
+uint64_t InstrumentFM::getArpeggioVersion() const
+{
+	return owner_->getArpeggioFMVersion(arpNum_);
+}
+
 std::unique_ptr<CommandSequence::Iterator> InstrumentFM::getArpeggioSequenceIterator() const
 {
 	return owner_->getArpeggioFMIterator(arpNum_);
@@ -316,12 +326,12 @@ int InstrumentFM::getPitchType() const
 	return owner_->getPitchFMType(ptNum_);
 }
 
-std::vector<CommandInSequence> InstrumentFM::getPitchSequence() const
+const std::vector<CommandInSequence>& InstrumentFM::getPitchSequence() const
 {
 	return owner_->getPitchFMSequence(ptNum_);
 }
 
-std::vector<Loop> InstrumentFM::getPitchLoops() const
+const std::vector<Loop>& InstrumentFM::getPitchLoops() const
 {
 	return owner_->getPitchFMLoops(ptNum_);
 }
@@ -331,6 +341,11 @@ Release InstrumentFM::getPitchRelease() const
 	return owner_->getPitchFMRelease(ptNum_);
 }
 
+uint64_t InstrumentFM::getPitchVersion() const
+{
+	return owner_->getPitchFMVersion(ptNum_);
+}
+
 std::unique_ptr<CommandSequence::Iterator> InstrumentFM::getPitchSequenceIterator() const
 {
 	return owner_->getPitchFMIterator(ptNum_);
@@ -389,12 +404,12 @@ int InstrumentSSG::getWaveFormNumber() const
 	return wfNum_;
 }
 
-std::vector<CommandInSequence> InstrumentSSG::getWaveFormSequence() const
+const std::vector<CommandInSequence>& InstrumentSSG::getWaveFormSequence() const
 {
 	return owner_->getWaveFormSSGSequence(wfNum_);
 }
 
-std::vector<Loop> InstrumentSSG::getWaveFormLoops() const
+const std::vector<Loop>& InstrumentSSG::getWaveFormLoops() const
 {
 	return owner_->getWaveFormSSGLoops(wfNum_);
 }
@@ -404,6 +419,11 @@ Release InstrumentSSG::getWaveFormRelease() const
 	return owner_->getWaveFormSSGRelease(wfNum_);
 }
 
+uint64_t InstrumentSSG::getWaveFormVersion() const
+{
+	return owner_->getWaveFormSSGVersion(wfNum_);
+}
+
 std::unique_ptr<CommandSequence::Iterator> InstrumentSSG::getWaveFormSequenceIterator() const
 {
 	return owner_->getWaveFormSSGIterator(wfNum_);
@@ -429,12 +449,12 @@ int InstrumentSSG::getToneNoiseNumber() const
 	return tnNum_;
 }
 
-std::vector<CommandInSequence> InstrumentSSG::getToneNoiseSequence() const
+const std::vector<CommandInSequence>& InstrumentSSG::getToneNoiseSequence() const
 {
 	return owner_->getToneNoiseSSGSequence(tnNum_);
 }
 
-std::vector<Loop> InstrumentSSG::getToneNoiseLoops() const
+const std::vector<Loop>& InstrumentSSG::getToneNoiseLoops() const
 {
 	return owner_->getToneNoiseSSGLoops(tnNum_);
 }
@@ -444,6 +464,11 @@ Release InstrumentSSG::getToneNoiseRelease() const
 	return owner_->getToneNoiseSSGRelease(tnNum_);
 }
 
+uint64_t InstrumentSSG::getToneNoiseVersion() const
+{
+	return owner_->getToneNoiseSSGVersion(tnNum_);
+}
+
 std::unique_ptr<CommandSequence::Iterator> InstrumentSSG::getToneNoiseSequenceIterator() const
 {
 	return owner_->getToneNoiseSSGIterator(tnNum_);
@@ -469,12 +494,12 @@ int InstrumentSSG::getEnvelopeNumber() const
 	return envNum_;
 }
 
-std::vector<CommandInSequence> InstrumentSSG::getEnvelopeSequence() const
+const std::vector<CommandInSequence>& InstrumentSSG::getEnvelopeSequence() const
 {
 	return owner_->getEnvelopeSSGSequence(envNum_);
 }
 
-std::vector<Loop> InstrumentSSG::getEnvelopeLoops() const
+const std::vector<Loop>& InstrumentSSG::getEnvelopeLoops() const
 {
 	return owner_->getEnvelopeSSGLoops(envNum_);
 }
@@ -484,6 +509,11 @@ Release InstrumentSSG::getEnvelopeRelease() const
 	return owner_->getEnvelopeSSGRelease(envNum_);
 }
 
+uint64_t InstrumentSSG::getEnvelopeVersion() const
+{
+	return owner_->getEnvelopeSSGVersion(envNum_);
+}
+
 std::unique_ptr<CommandSequence::Iterator> InstrumentSSG::getEnvelopeSequenceIterator() const
 {
 	return owner_->getEnvelopeSSGIterator(envNum_);
@@ -514,12 +544,12 @@ int InstrumentSSG::getArpeggioType() const
 	return owner_->getArpeggioSSGType(arpNum_);
 }
 
-std::vector<CommandInSequence> InstrumentSSG::getArpeggioSequence() const
+const std::vector<CommandInSequence>& InstrumentSSG::getArpeggioSequence() const
 {
 	return owner_->getArpeggioSSGSequence(arpNum_);
 }
 
-std::vector<Loop> InstrumentSSG::getArpeggioLoops() const
+const std::vector<Loop>& InstrumentSSG::getArpeggioLoops() const
 {
 	return owner_->getArpeggioSSGLoops(arpNum_);
 }
@@ -529,6 +559,11 @@ Release InstrumentSSG::getArpeggioRelease() const
 	return owner_->getArpeggioSSGRelease(arpNum_);
 }
 
+uint64_t InstrumentSSG::getArpeggioVersion() const
+{
+	return owner_->getArpeggioSSGVersion(arpNum_);
+}
+
 std::unique_ptr<CommandSequence::Iterator> InstrumentSSG::getArpeggioSequenceIterator() const
 {
 	return owner_->getArpeggioSSGIterator(arpNum_);
@@ -559,12 +594,12 @@ int InstrumentSSG::getPitchType() const
 	return owner_->getPitchSSGType(ptNum_);
 }
 
-std::vector<CommandInSequence> InstrumentSSG::getPitchSequence() const
+const std::vector<CommandInSequence>& InstrumentSSG::getPitchSequence() const
 {
 	return owner_->getPitchSSGSequence(ptNum_);
 }
 
-std::vector<Loop> InstrumentSSG::getPitchLoops() const
+const std::vector<Loop>& InstrumentSSG::getPitchLoops() const
 {
 	return owner_->getPitchSSGLoops(ptNum_);
 }
@@ -574,6 +609,11 @@ Release InstrumentSSG::getPitchRelease() const
 	return owner_->getPitchSSGRelease(ptNum_);
 }
 
+uint64_t InstrumentSSG::getPitchVersion() const
+{
+	return owner_->getPitchSSGVersion(ptNum_);
+}
+
 std::unique_ptr<CommandSequence::Iterator> InstrumentSSG::getPitchSequenceIterator() const
 {
 	return owner_->getPitchSSGIterator(ptNum_);
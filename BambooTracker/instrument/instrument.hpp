@@ -57,9 +57,10 @@ public:
 	bool getOperatorSequenceEnabled(FMEnvelopeParameter param) const;
 	void setOperatorSequenceNumber(FMEnvelopeParameter param, int n);
 	int getOperatorSequenceNumber(FMEnvelopeParameter param) const;
-	std::vector<CommandInSequence> getOperatorSequenceSequence(FMEnvelopeParameter param) const;
-	std::vector<Loop> getOperatorSequenceLoops(FMEnvelopeParameter param) const;
+	const std::vector<CommandInSequence>& getOperatorSequenceSequence(FMEnvelopeParameter param) const;
+	const std::vector<Loop>& getOperatorSequenceLoops(FMEnvelopeParameter param) const;
 	Release getOperatorSequenceRelease(FMEnvelopeParameter param) const;
+	uint64_t getOperatorSequenceVersion(FMEnvelopeParameter param) const;
 	std::unique_ptr<CommandSequence::Iterator> getOperatorSequenceSequenceIterator(FMEnvelopeParameter param) const;
 
 	void setArpeggioEnabled(bool enabled);
@@ -67,9 +68,10 @@ public:
 	void setArpeggioNumber(int n);
 	int getArpeggioNumber() const;
 	int getArpeggioType() const;
-	std::vector<CommandInSequence> getArpeggioSequence() const;
-	std::vector<Loop> getArpeggioLoops() const;
+	const std::vector<CommandInSequence>& getArpeggioSequence() const;
+	const std::vector<Loop>& getArpeggioLoops() const;
 	Release getArpeggioRelease() const;
+	uint64_t getArpeggioVersion() const;
 	std::unique_ptr<CommandSequence::Iterator> getArpeggioSequenceIterator() const;
 
 	void setPitchEnabled(bool enabled);
@@ -77,9 +79,10 @@ public:
 	void setPitchNumber(int n);
 	int getPitchNumber() const;
 	int getPitchType() const;
-	std::vector<CommandInSequence> getPitchSequence() const;
-	std::vector<Loop> getPitchLoops() const;
+	const std::vector<CommandInSequence>& getPitchSequence() const;
+	const std::vector<Loop>& getPitchLoops() const;
 	Release getPitchRelease() const;
+	uint64_t getPitchVersion() const;
 	std::unique_ptr<CommandSequence::Iterator> getPitchSequenceIterator() const;
 
 	void setEnvelopeResetEnabled(bool enabled);
@@ -110,27 +113,30 @@ public:
 	bool getWaveFormEnabled() const;
 	void setWaveFormNumber(int n);
 	int getWaveFormNumber() const;
-	std::vector<CommandInSequence> getWaveFormSequence() const;
-	std::vector<Loop> getWaveFormLoops() const;
+	const std::vector<CommandInSequence>& getWaveFormSequence() const;
+	const std::vector<Loop>& getWaveFormLoops() const;
 	Release getWaveFormRelease() const;
+	uint64_t getWaveFormVersion() const;
 	std::unique_ptr<CommandSequence::Iterator> getWaveFormSequenceIterator() const;
 
 	void setToneNoiseEnabled(bool enabled);
 	bool getToneNoiseEnabled() const;
 	void setToneNoiseNumber(int n);
 	int getToneNoiseNumber() const;
-	std::vector<CommandInSequence> getToneNoiseSequence() const;
-	std::vector<Loop> getToneNoiseLoops() const;
+	const std::vector<CommandInSequence>& getToneNoiseSequence() const;
+	const std::vector<Loop>& getToneNoiseLoops() const;
 	Release getToneNoiseRelease() const;
+	uint64_t getToneNoiseVersion() const;
 	std::unique_ptr<CommandSequence::Iterator> getToneNoiseSequenceIterator() const;
 
 	void setEnvelopeEnabled(bool enabled);
 	bool getEnvelopeEnabled() const;
 	void setEnvelopeNumber(int n);
 	int getEnvelopeNumber() const;
-	std::vector<CommandInSequence> getEnvelopeSequence() const;
-	std::vector<Loop> getEnvelopeLoops() const;
+	const std::vector<CommandInSequence>& getEnvelopeSequence() const;
+	const std::vector<Loop>& getEnvelopeLoops() const;
 	Release getEnvelopeRelease() const;
+	uint64_t getEnvelopeVersion() const;
 	std::unique_ptr<CommandSequence::Iterator> getEnvelopeSequenceIterator() const;
 
 	void setArpeggioEnabled(bool enabled);
@@ -138,9 +144,10 @@ public:
 	void setArpeggioNumber(int n);
 	int getArpeggioNumber() const;
 	int getArpeggioType() const;
-	std::vector<CommandInSequence> getArpeggioSequence() const;
-	std::vector<Loop> getArpeggioLoops() const;
+	const std::vector<CommandInSequence>& getArpeggioSequence() const;
+	const std::vector<Loop>& getArpeggioLoops() const;
 	Release getArpeggioRelease() const;
+	uint64_t getArpeggioVersion() const;
 	std::unique_ptr<CommandSequence::Iterator> getArpeggioSequenceIterator() const;
 
 	void setPitchEnabled(bool enabled);
@@ -148,9 +155,10 @@ public:
 	void setPitchNumber(int n);
 	int getPitchNumber() const;
 	int getPitchType() const;
-	std::vector<CommandInSequence> getPitchSequence() const;
-	std::vector<Loop> getPitchLoops() const;
+	const std::vector<CommandInSequence>& getPitchSequence() const;
+	const std::vector<Loop>& getPitchLoops() const;
 	Release getPitchRelease() const;
+	uint64_t getPitchVersion() const;
 	std::unique_ptr<CommandSequence::Iterator> getPitchSequenceIterator() const;
 
 private:
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+/// Fixed-size table of instrument properties.
+/// A property is created when it is first accessed for modification,
+/// and blank slots share one default instance for reading.
+template <class T>
+class InstrumentPropertyTable
+{
+public:
+	explicit InstrumentPropertyTable(std::function<std::shared_ptr<T>(int)> create);
+
+	/// Property for reading.
+	/// Blank slots return the shared default instance, which must not be modified
+	const std::shared_ptr<T>& get(size_t n) const;
+	/// Property for modification, created on first call
+	std::shared_ptr<T>& at(size_t n);
+
+	bool isCreated(size_t n) const;
+	/// Return the slot to blank
+	void reset(size_t n);
+	void clear();
+	size_t size() const;
+
+private:
+	std::function<std::shared_ptr<T>(int)> create_;
+	std::shared_ptr<T> default_;
+	std::array<std::shared_ptr<T>, 128> props_;
+};
+
+template <class T>
+InstrumentPropertyTable<T>::InstrumentPropertyTable(std::function<std::shared_ptr<T>(int)> create)
+	: create_(create),
+	  default_(create(-1))
+{
+}
+
+template <class T>
+const std::shared_ptr<T>& InstrumentPropertyTable<T>::get(size_t n) const
+{
+	const std::shared_ptr<T>& prop = props_.at(n);
+	return prop ? prop : default_;
+}
+
+template <class T>
+std::shared_ptr<T>& InstrumentPropertyTable<T>::at(size_t n)
+{
+	std::shared_ptr<T>& prop = props_.at(n);
+	if (!prop) prop = create_(static_cast<int>(n));
+	return prop;
+}
+
+template <class T>
+bool InstrumentPropertyTable<T>::isCreated(size_t n) const
+{
+	return props_.at(n) != nullptr;
+}
+
+template <class T>
+void InstrumentPropertyTable<T>::reset(size_t n)
+{
+	props_.at(n).reset();
+}
+
+template <class T>
+void InstrumentPropertyTable<T>::clear()
+{
+	for (auto& prop : props_) prop.reset();
+}
+
+template <class T>
+size_t InstrumentPropertyTable<T>::size() const
+{
+	return props_.size();
+}
@@ -0,0 +1,109 @@
+#include "instrument_user_set.hpp"
+
+InstrumentUserSet::InstrumentUserSet()
+	: words_{ 0, 0 }
+{
+}
+
+void InstrumentUserSet::insert(int instNum)
+{
+	words_[instNum >> 6] |= (uint64_t(1) << (instNum & 63));
+}
+
+void InstrumentUserSet::erase(int instNum)
+{
+	words_[instNum >> 6] &= ~(uint64_t(1) << (instNum & 63));
+}
+
+void InstrumentUserSet::clear()
+{
+	words_[0] = 0;
+	words_[1] = 0;
+}
+
+bool InstrumentUserSet::contains(int instNum) const
+{
+	return (words_[instNum >> 6] >> (instNum & 63)) & 1;
+}
+
+bool InstrumentUserSet::empty() const
+{
+	return !(words_[0] | words_[1]);
+}
+
+size_t InstrumentUserSet::size() const
+{
+	return static_cast<size_t>(countBits(words_[0]) + countBits(words_[1]));
+}
+
+InstrumentUserSet::Iterator InstrumentUserSet::begin() const
+{
+	return Iterator(words_, 0);
+}
+
+InstrumentUserSet::Iterator InstrumentUserSet::end() const
+{
+	return Iterator(words_, 128);
+}
+
+int InstrumentUserSet::countBits(uint64_t w)
+{
+	w = w - ((w >> 1) & 0x5555555555555555);
+	w = (w & 0x3333333333333333) + ((w >> 2) & 0x3333333333333333);
+	w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0f;
+	return static_cast<int>((w * 0x0101010101010101) >> 56);
+}
+
+/// w must not be 0
+int InstrumentUserSet::findLowestBit(uint64_t w)
+{
+	// De Bruijn sequence lookup
+	static const int TABLE[64] = {
+		0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+		62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+		63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+		46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+	};
+	return TABLE[((w & (~w + 1)) * 0x03f79d71b4cb0a89) >> 58];
+}
+
+/****************************************/
+InstrumentUserSet::Iterator::Iterator(const uint64_t* words, int n)
+	: words_(words)
+{
+	seek(n);
+}
+
+int InstrumentUserSet::Iterator::operator*() const
+{
+	return n_;
+}
+
+InstrumentUserSet::Iterator& InstrumentUserSet::Iterator::operator++()
+{
+	seek(n_ + 1);
+	return *this;
+}
+
+bool InstrumentUserSet::Iterator::operator==(const Iterator& other) const
+{
+	return (words_ == other.words_ && n_ == other.n_);
+}
+
+bool InstrumentUserSet::Iterator::operator!=(const Iterator& other) const
+{
+	return !(*this == other);
+}
+
+void InstrumentUserSet::Iterator::seek(int begin)
+{
+	for (int i = begin >> 6; i < 2 && begin < 128; ++i) {
+		uint64_t w = words_[i];
+		if (i == (begin >> 6)) w &= (~uint64_t(0) << (begin & 63));
+		if (w) {
+			n_ = (i << 6) + findLowestBit(w);
+			return;
+		}
+	}
+	n_ = 128;
+}
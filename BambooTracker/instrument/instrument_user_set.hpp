@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+
+/// Set of the numbers of instruments using a property.
+/// It is a 128-bit set, so it is cheap to copy and iterates in ascending order.
+class InstrumentUserSet
+{
+public:
+	InstrumentUserSet();
+
+	void insert(int instNum);
+	void erase(int instNum);
+	void clear();
+	bool contains(int instNum) const;
+	bool empty() const;
+	size_t size() const;
+
+	class Iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = int;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const int*;
+		using reference = int;
+
+		Iterator(const uint64_t* words, int n);
+		int operator*() const;
+		Iterator& operator++();
+		bool operator==(const Iterator& other) const;
+		bool operator!=(const Iterator& other) const;
+
+	private:
+		const uint64_t* words_;
+		int n_;
+
+		void seek(int begin);
+	};
+
+	Iterator begin() const;
+	Iterator end() const;
+
+private:
+	uint64_t words_[2];
+
+	static int countBits(uint64_t w);
+	static int findLowestBit(uint64_t w);
+};
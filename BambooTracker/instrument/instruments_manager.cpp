@@ -3,6 +3,15 @@
 #include "instrument.hpp"
 
 InstrumentsManager::InstrumentsManager()
+	: envFM_([](int n) { return std::make_shared<EnvelopeFM>(n); }),
+	  lfoFM_([](int n) { return std::make_shared<LFOFM>(n); }),
+	  arpFM_([](int n) { return std::make_shared<CommandSequence>(n, 0, 48); }),
+	  ptFM_([](int n) { return std::make_shared<CommandSequence>(n, 0, 127); }),
+	  wfSSG_([](int n) { return std::make_shared<CommandSequence>(n, 0); }),
+	  envSSG_([](int n) { return std::make_shared<CommandSequence>(n, 0, 15); }),
+	  tnSSG_([](int n) { return std::make_shared<CommandSequence>(n, 0); }),
+	  arpSSG_([](int n) { return std::make_shared<CommandSequence>(n, 0, 48); }),
+	  ptSSG_([](int n) { return std::make_shared<CommandSequence>(n, 0, 127); })
 {
 	envFMParams_ = {
 		FMEnvelopeParameter::AL,
@@ -45,7 +54,10 @@ InstrumentsManager::InstrumentsManager()
 		FMEnvelopeParameter::DT4
 	};
 
-	clearAll();
+	// Properties are created when they are used or edited first
+	for (auto p : envFMParams_) {
+		opSeqFM_.emplace(p, [](int n) { return std::make_shared<CommandSequence>(n, 0); });
+	}
 }
 
 void InstrumentsManager::addInstrument(int instNum, SoundSource source, std::string name)
@@ -110,6 +122,8 @@ void InstrumentsManager::addInstrument(int instNum, SoundSource source, std::str
 	default:
 		break;
 	}
+
+	publishInstrument(instNum);
 }
 
 void InstrumentsManager::addInstrument(std::unique_ptr<AbstractInstrument> inst)
@@ -144,6 +158,8 @@ void InstrumentsManager::addInstrument(std::unique_ptr<AbstractInstrument> inst)
 	default:
 		break;
 	}
+
+	publishInstrument(num);
 }
 
 void InstrumentsManager::cloneInstrument(int cloneInstNum, int refInstNum)
@@ -202,35 +218,35 @@ void InstrumentsManager::deepCloneInstrument(int cloneInstNum, int refInstNum)
 		auto refFm = std::dynamic_pointer_cast<InstrumentFM>(refInst);
 		auto cloneFm = std::dynamic_pointer_cast<InstrumentFM>(insts_.at(cloneInstNum));
 		
-		envFM_[cloneFm->getEnvelopeNumber()]->deregisterUserInstrument(cloneInstNum);	// Remove temporary number
+		envFM_.at(cloneFm->getEnvelopeNumber())->deregisterUserInstrument(cloneInstNum);	// Remove temporary number
 		int envNum = cloneFMEnvelope(refFm->getEnvelopeNumber());
 		cloneFm->setEnvelopeNumber(envNum);
-		envFM_[envNum]->registerUserInstrument(cloneInstNum);
+		envFM_.at(envNum)->registerUserInstrument(cloneInstNum);
 		if (refFm->getLFOEnabled()) {
 			cloneFm->setLFOEnabled(true);
 			int lfoNum = cloneFMLFO(refFm->getLFONumber());
 			cloneFm->setLFONumber(lfoNum);
-			lfoFM_[lfoNum]->registerUserInstrument(cloneInstNum);
+			lfoFM_.at(lfoNum)->registerUserInstrument(cloneInstNum);
 		}
 		for (auto p : envFMParams_) {
 			if (refFm->getOperatorSequenceEnabled(p)) {
 				cloneFm->setOperatorSequenceEnabled(p, true);
 				int opSeqNum = cloneFMOperatorSequence(p, refFm->getOperatorSequenceNumber(p));
 				cloneFm->setOperatorSequenceNumber(p, opSeqNum);
-				opSeqFM_.at(p)[opSeqNum]->registerUserInstrument(cloneInstNum);
+				opSeqFM_.at(p).at(opSeqNum)->registerUserInstrument(cloneInstNum);
 			}
 		}
 		if (refFm->getArpeggioEnabled()) {
 			cloneFm->setArpeggioEnabled(true);
 			int arpNum = cloneFMArpeggio(refFm->getArpeggioNumber());
 			cloneFm->setArpeggioNumber(arpNum);
-			arpFM_[arpNum]->registerUserInstrument(cloneInstNum);
+			arpFM_.at(arpNum)->registerUserInstrument(cloneInstNum);
 		}
 		if (refFm->getPitchEnabled()) {
 			cloneFm->setPitchEnabled(true);
 			int ptNum = cloneFMPitch(refFm->getPitchNumber());
 			cloneFm->setPitchNumber(ptNum);
-			ptFM_[ptNum]->registerUserInstrument(cloneInstNum);
+			ptFM_.at(ptNum)->registerUserInstrument(cloneInstNum);
 		}
 		setInstrumentFMEnvelopeResetEnabled(cloneInstNum, refFm->getEnvelopeResetEnabled());
 		break;
@@ -244,177 +260,169 @@ void InstrumentsManager::deepCloneInstrument(int cloneInstNum, int refInstNum)
 			cloneSsg->setWaveFormEnabled(true);
 			int wfNum = cloneSSGWaveForm(refSsg->getWaveFormNumber());
 			cloneSsg->setWaveFormNumber(wfNum);
-			wfSSG_[wfNum]->registerUserInstrument(cloneInstNum);
+			wfSSG_.at(wfNum)->registerUserInstrument(cloneInstNum);
 		}
 		if (refSsg->getToneNoiseEnabled()) {
 			cloneSsg->setToneNoiseEnabled(true);
 			int tnNum = cloneSSGToneNoise(refSsg->getToneNoiseNumber());
 			cloneSsg->setToneNoiseNumber(tnNum);
-			tnSSG_[tnNum]->registerUserInstrument(cloneInstNum);
+			tnSSG_.at(tnNum)->registerUserInstrument(cloneInstNum);
 		}
 		if (refSsg->getEnvelopeEnabled()) {
 			cloneSsg->setEnvelopeEnabled(true);
 			int envNum = cloneSSGEnvelope(refSsg->getEnvelopeNumber());
 			cloneSsg->setEnvelopeNumber(envNum);
-			envSSG_[envNum]->registerUserInstrument(cloneInstNum);
+			envSSG_.at(envNum)->registerUserInstrument(cloneInstNum);
 		}
 		if (refSsg->getArpeggioEnabled()) {
 			cloneSsg->setArpeggioEnabled(true);
 			int arpNum = cloneSSGArpeggio(refSsg->getArpeggioNumber());
 			cloneSsg->setArpeggioNumber(arpNum);
-			arpSSG_[arpNum]->registerUserInstrument(cloneInstNum);
+			arpSSG_.at(arpNum)->registerUserInstrument(cloneInstNum);
 		}
 		if (refSsg->getPitchEnabled()) {
 			cloneSsg->setPitchEnabled(true);
 			int ptNum = cloneSSGPitch(refSsg->getPitchNumber());
 			cloneSsg->setPitchNumber(ptNum);
-			ptSSG_[ptNum]->registerUserInstrument(cloneInstNum);
+			ptSSG_.at(ptNum)->registerUserInstrument(cloneInstNum);
 		}
 		break;
 	}
 	default:
 		break;
 	}
+
+	publishInstrument(cloneInstNum);
 }
 
 int InstrumentsManager::cloneFMEnvelope(int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& env : envFM_) {
-		if (!env->isUserInstrument()) {
-			env = envFM_.at(srcNum)->clone();
-			env->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < envFM_.size(); ++cloneNum) {
+		if (!envFM_.get(cloneNum)->isUserInstrument()) {
+			envFM_.at(cloneNum) = envFM_.get(srcNum)->clone();
+			envFM_.at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 int InstrumentsManager::cloneFMLFO(int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& lfo : lfoFM_) {
-		if (!lfo->isUserInstrument()) {
-			lfo = lfoFM_.at(srcNum)->clone();
-			lfo->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < lfoFM_.size(); ++cloneNum) {
+		if (!lfoFM_.get(cloneNum)->isUserInstrument()) {
+			lfoFM_.at(cloneNum) = lfoFM_.get(srcNum)->clone();
+			lfoFM_.at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 int InstrumentsManager::cloneFMOperatorSequence(FMEnvelopeParameter param, int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& opSeq : opSeqFM_.at(param)) {
-		if (!opSeq->isUserInstrument()) {
-			opSeq = opSeqFM_.at(param).at(srcNum)->clone();
-			opSeq->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < opSeqFM_.at(param).size(); ++cloneNum) {
+		if (!opSeqFM_.at(param).get(cloneNum)->isUserInstrument()) {
+			opSeqFM_.at(param).at(cloneNum) = opSeqFM_.at(param).get(srcNum)->clone();
+			opSeqFM_.at(param).at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 int InstrumentsManager::cloneFMArpeggio(int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& arp : arpFM_) {
-		if (!arp->isUserInstrument()) {
-			arp = arpFM_.at(srcNum)->clone();
-			arp->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < arpFM_.size(); ++cloneNum) {
+		if (!arpFM_.get(cloneNum)->isUserInstrument()) {
+			arpFM_.at(cloneNum) = arpFM_.get(srcNum)->clone();
+			arpFM_.at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 int InstrumentsManager::cloneFMPitch(int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& pt : ptFM_) {
-		if (!pt->isUserInstrument()) {
-			pt = ptFM_.at(srcNum)->clone();
-			pt->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < ptFM_.size(); ++cloneNum) {
+		if (!ptFM_.get(cloneNum)->isUserInstrument()) {
+			ptFM_.at(cloneNum) = ptFM_.get(srcNum)->clone();
+			ptFM_.at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 int InstrumentsManager::cloneSSGWaveForm(int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& wf : wfSSG_) {
-		if (!wf->isUserInstrument()) {
-			wf = wfSSG_.at(srcNum)->clone();
-			wf->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < wfSSG_.size(); ++cloneNum) {
+		if (!wfSSG_.get(cloneNum)->isUserInstrument()) {
+			wfSSG_.at(cloneNum) = wfSSG_.get(srcNum)->clone();
+			wfSSG_.at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 int InstrumentsManager::cloneSSGToneNoise(int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& tn : tnSSG_) {
-		if (!tn->isUserInstrument()) {
-			tn = tnSSG_.at(srcNum)->clone();
-			tn->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < tnSSG_.size(); ++cloneNum) {
+		if (!tnSSG_.get(cloneNum)->isUserInstrument()) {
+			tnSSG_.at(cloneNum) = tnSSG_.get(srcNum)->clone();
+			tnSSG_.at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 int InstrumentsManager::cloneSSGEnvelope(int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& env : envSSG_) {
-		if (!env->isUserInstrument()) {
-			env = envSSG_.at(srcNum)->clone();
-			env->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < envSSG_.size(); ++cloneNum) {
+		if (!envSSG_.get(cloneNum)->isUserInstrument()) {
+			envSSG_.at(cloneNum) = envSSG_.get(srcNum)->clone();
+			envSSG_.at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 int InstrumentsManager::cloneSSGArpeggio(int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& arp : arpSSG_) {
-		if (!arp->isUserInstrument()) {
-			arp = arpSSG_.at(srcNum)->clone();
-			arp->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < arpSSG_.size(); ++cloneNum) {
+		if (!arpSSG_.get(cloneNum)->isUserInstrument()) {
+			arpSSG_.at(cloneNum) = arpSSG_.get(srcNum)->clone();
+			arpSSG_.at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 int InstrumentsManager::cloneSSGPitch(int srcNum)
 {
-	int cloneNum = 0;
-	for (auto& pt : ptSSG_) {
-		if (!pt->isUserInstrument()) {
-			pt = ptSSG_.at(srcNum)->clone();
-			pt->setNumber(cloneNum);
+	size_t cloneNum = 0;
+	for (; cloneNum < ptSSG_.size(); ++cloneNum) {
+		if (!ptSSG_.get(cloneNum)->isUserInstrument()) {
+			ptSSG_.at(cloneNum) = ptSSG_.get(srcNum)->clone();
+			ptSSG_.at(cloneNum)->setNumber(cloneNum);
 			break;
 		}
-		++cloneNum;
 	}
-	return cloneNum;
+	return static_cast<int>(cloneNum);
 }
 
 std::unique_ptr<AbstractInstrument> InstrumentsManager::removeInstrument(int instNum)
@@ -449,6 +457,7 @@ std::unique_ptr<AbstractInstrument> InstrumentsManager::removeInstrument(int ins
 
 	std::unique_ptr<AbstractInstrument> clone = insts_[instNum]->clone();
 	insts_[instNum].reset();
+	publishInstrument(instNum);
 	return clone;
 }
 
@@ -462,29 +471,39 @@ std::shared_ptr<AbstractInstrument> InstrumentsManager::getInstrumentSharedPtr(i
 	}
 }
 
-void InstrumentsManager::clearAll()
+std::shared_ptr<const AbstractInstrument> InstrumentsManager::getInstrumentSnapshot(int instNum) const
 {
-	for (auto p : envFMParams_) {
-		opSeqFM_.emplace(p, std::array<std::shared_ptr<CommandSequence>, 128>());
+	if (0 <= instNum && static_cast<size_t>(instNum) < snapshots_.size()) {
+		return std::atomic_load(&snapshots_[instNum]);
+	}
+	else {
+		return std::shared_ptr<const AbstractInstrument>();
 	}
+}
 
-	for (size_t i = 0; i < 128; ++i) {
-		insts_[i].reset();
+void InstrumentsManager::publishInstrument(int instNum)
+{
+	std::shared_ptr<const AbstractInstrument> snapshot;
+	if (insts_.at(instNum)) snapshot = insts_[instNum]->clone();
+	std::atomic_store(&snapshots_.at(instNum), std::move(snapshot));
+}
 
-		envFM_[i] = std::make_shared<EnvelopeFM>(i);
-		lfoFM_[i] = std::make_shared<LFOFM>(i);
-		for (auto& p : opSeqFM_) {
-			p.second[i] = std::make_shared<CommandSequence>(i, 0);
-		}
-		arpFM_[i] = std::make_shared<CommandSequence>(i, 0, 48);
-		ptFM_[i] = std::make_shared<CommandSequence>(i, 0, 127);
+void InstrumentsManager::clearAll()
+{
+	for (auto& inst : insts_) inst.reset();
+	for (size_t i = 0; i < insts_.size(); ++i) publishInstrument(i);
 
-		wfSSG_[i] = std::make_shared<CommandSequence>(i, 0);
-		tnSSG_[i] = std::make_shared<CommandSequence>(i, 0);
-		envSSG_[i] = std::make_shared<CommandSequence>(i, 0, 15);
-		arpSSG_[i] = std::make_shared<CommandSequence>(i, 0, 48);
-		ptSSG_[i] = std::make_shared<CommandSequence>(i, 0, 127);
-	}
+	envFM_.clear();
+	lfoFM_.clear();
+	for (auto& p : opSeqFM_) p.second.clear();
+	arpFM_.clear();
+	ptFM_.clear();
+
+	wfSSG_.clear();
+	tnSSG_.clear();
+	envSSG_.clear();
+	arpSSG_.clear();
+	ptSSG_.clear();
 }
 
 std::vector<int> InstrumentsManager::getInstrumentIndices() const
@@ -499,6 +518,7 @@ std::vector<int> InstrumentsManager::getInstrumentIndices() const
 void InstrumentsManager::setInstrumentName(int instNum, std::string name)
 {
 	insts_.at(instNum)->setName(name);
+	publishInstrument(instNum);
 }
 
 std::string InstrumentsManager::getInstrumentName(int instNum) const
@@ -520,30 +540,83 @@ std::vector<int> InstrumentsManager::getEntriedInstrumentIndices() const
 void InstrumentsManager::clearUnusedInstrumentProperties()
 {
 	for (size_t i = 0; i < 128; ++i) {
-		if (!envFM_[i]->isUserInstrument())
-			envFM_[i] = std::make_shared<EnvelopeFM>(i);
-		if (!lfoFM_[i]->isUserInstrument())
-			lfoFM_[i] = std::make_shared<LFOFM>(i);
-		for (auto& p : opSeqFM_) {
-			if (!p.second[i]->isUserInstrument())
-				p.second[i] = std::make_shared<CommandSequence>(i, 0);
+		clearUnusedProperty(envFM_, i);
+		clearUnusedProperty(lfoFM_, i);
+		for (auto& p : opSeqFM_) clearUnusedProperty(p.second, i);
+		clearUnusedProperty(arpFM_, i);
+		clearUnusedProperty(ptFM_, i);
+
+		clearUnusedProperty(wfSSG_, i);
+		clearUnusedProperty(tnSSG_, i);
+		clearUnusedProperty(envSSG_, i);
+		clearUnusedProperty(arpSSG_, i);
+		clearUnusedProperty(ptSSG_, i);
+	}
+}
+
+template <class T>
+void InstrumentsManager::clearUnusedProperty(InstrumentPropertyTable<T>& props, int num)
+{
+	// Skip properties which are already blank
+	if (props.isCreated(num) && !props.get(num)->isUserInstrument()) props.reset(num);
+}
+
+void InstrumentsManager::reuseIdenticalProperties(AbstractInstrument* inst)
+{
+	switch (inst->getSoundSource()) {
+	case SoundSource::FM:
+	{
+		auto fm = dynamic_cast<InstrumentFM*>(inst);
+		fm->setEnvelopeNumber(reuseProperty(envFM_, fm->getEnvelopeNumber()));
+		if (fm->getLFOEnabled())
+			fm->setLFONumber(reuseProperty(lfoFM_, fm->getLFONumber()));
+		for (auto p : envFMParams_) {
+			if (fm->getOperatorSequenceEnabled(p))
+				fm->setOperatorSequenceNumber(p, reuseProperty(opSeqFM_.at(p), fm->getOperatorSequenceNumber(p)));
 		}
-		if (!arpFM_[i]->isUserInstrument())
-			arpFM_[i] = std::make_shared<CommandSequence>(i, 0, 48);
-		if (!ptFM_[i]->isUserInstrument())
-			ptFM_[i] = std::make_shared<CommandSequence>(i, 0, 127);
+		if (fm->getArpeggioEnabled())
+			fm->setArpeggioNumber(reuseProperty(arpFM_, fm->getArpeggioNumber()));
+		if (fm->getPitchEnabled())
+			fm->setPitchNumber(reuseProperty(ptFM_, fm->getPitchNumber()));
+		break;
+	}
+	case SoundSource::SSG:
+	{
+		auto ssg = dynamic_cast<InstrumentSSG*>(inst);
+		if (ssg->getWaveFormEnabled())
+			ssg->setWaveFormNumber(reuseProperty(wfSSG_, ssg->getWaveFormNumber()));
+		if (ssg->getToneNoiseEnabled())
+			ssg->setToneNoiseNumber(reuseProperty(tnSSG_, ssg->getToneNoiseNumber()));
+		if (ssg->getEnvelopeEnabled())
+			ssg->setEnvelopeNumber(reuseProperty(envSSG_, ssg->getEnvelopeNumber()));
+		if (ssg->getArpeggioEnabled())
+			ssg->setArpeggioNumber(reuseProperty(arpSSG_, ssg->getArpeggioNumber()));
+		if (ssg->getPitchEnabled())
+			ssg->setPitchNumber(reuseProperty(ptSSG_, ssg->getPitchNumber()));
+		break;
+	}
+	default:
+		break;
+	}
+}
 
-		if (!wfSSG_[i]->isUserInstrument())
-			wfSSG_[i] = std::make_shared<CommandSequence>(i, 0);
-		if (!tnSSG_[i]->isUserInstrument())
-			tnSSG_[i] = std::make_shared<CommandSequence>(i, 0);
-		if (!envSSG_[i]->isUserInstrument())
-			envSSG_[i] = std::make_shared<CommandSequence>(i, 0, 15);
-		if (!arpSSG_[i]->isUserInstrument())
-			arpSSG_[i] = std::make_shared<CommandSequence>(i, 0, 48);
-		if (!ptSSG_[i]->isUserInstrument())
-			ptSSG_[i] = std::make_shared<CommandSequence>(i, 0, 127);
+/// Return:
+///		the number of the identical property used by other instruments if it exists,
+///		else: num
+template <class T>
+int InstrumentsManager::reuseProperty(InstrumentPropertyTable<T>& props, int num)
+{
+	// Properties shared with other instruments are kept
+	if (props.get(num)->isUserInstrument()) return num;
+
+	// Content hashes are compared first, so the scan is cheap
+	for (int i = 0; i < 128; ++i) {
+		if (i != num && props.get(i)->isUserInstrument() && props.get(i)->hasSameContent(*props.get(num))) {
+			props.reset(num);
+			return i;
+		}
 	}
+	return num;
 }
 
 /// Return:
@@ -567,6 +640,7 @@ void InstrumentsManager::setInstrumentFMEnvelope(int instNum, int envNum)
 	envFM_.at(envNum)->registerUserInstrument(instNum);
 
 	fm->setEnvelopeNumber(envNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentFMEnvelope(int instNum) const
@@ -581,7 +655,7 @@ void InstrumentsManager::setEnvelopeFMParameter(int envNum, FMEnvelopeParameter
 
 int InstrumentsManager::getEnvelopeFMParameter(int envNum, FMEnvelopeParameter param) const
 {
-	return envFM_.at(envNum)->getParameterValue(param);
+	return envFM_.get(envNum)->getParameterValue(param);
 }
 
 void InstrumentsManager::setEnvelopeFMOperatorEnabled(int envNum, int opNum, bool enabled)
@@ -591,21 +665,19 @@ void InstrumentsManager::setEnvelopeFMOperatorEnabled(int envNum, int opNum, boo
 
 bool InstrumentsManager::getEnvelopeFMOperatorEnabled(int envNum, int opNum) const
 {
-	return envFM_.at(envNum)->getOperatorEnabled(opNum);
+	return envFM_.get(envNum)->getOperatorEnabled(opNum);
 }
 
-std::vector<int> InstrumentsManager::getEnvelopeFMUsers(int envNum) const
+InstrumentUserSet InstrumentsManager::getEnvelopeFMUsers(int envNum) const
 {
-	return envFM_.at(envNum)->getUserInstruments();
+	return envFM_.get(envNum)->getUserInstruments();
 }
 
 std::vector<int> InstrumentsManager::getEnvelopeFMEntriedIndices() const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& env : envFM_) {
-		if (env->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < envFM_.size(); ++i) {
+		if (envFM_.get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -614,7 +686,7 @@ int InstrumentsManager::findFirstFreeEnvelopeFM() const
 {
 	size_t i = 0;
 	for (size_t i = 0; i < envFM_.size(); ++i) {
-		if (!envFM_[i]->isUserInstrument()) return i;
+		if (!envFM_.get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -623,7 +695,7 @@ int InstrumentsManager::findFirstFreePlainEnvelopeFM() const
 {
 	size_t i = 0;
 	for (size_t i = 0; i < envFM_.size(); ++i) {
-		if (!envFM_[i]->isUserInstrument() && !envFM_[i]->isEdited()) return i;
+		if (!envFM_.get(i)->isUserInstrument() && !envFM_.get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -634,6 +706,7 @@ void InstrumentsManager::setInstrumentFMLFOEnabled(int instNum, bool enabled)
 	fm->setLFOEnabled(enabled);
 	if (enabled) lfoFM_.at(fm->getLFONumber())->registerUserInstrument(instNum);
 	else lfoFM_.at(fm->getLFONumber())->deregisterUserInstrument(instNum);
+	publishInstrument(instNum);
 }
 bool InstrumentsManager::getInstrumentFMLFOEnabled(int instNum) const
 {
@@ -648,6 +721,7 @@ void InstrumentsManager::setInstrumentFMLFO(int instNum, int lfoNum)
 		lfoFM_.at(lfoNum)->registerUserInstrument(instNum);
 	}
 	fm->setLFONumber(lfoNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentFMLFO(int instNum) const
@@ -662,21 +736,19 @@ void InstrumentsManager::setLFOFMParameter(int lfoNum, FMLFOParameter param, int
 
 int InstrumentsManager::getLFOFMparameter(int lfoNum, FMLFOParameter param) const
 {
-	return lfoFM_.at(lfoNum)->getParameterValue(param);
+	return lfoFM_.get(lfoNum)->getParameterValue(param);
 }
 
-std::vector<int> InstrumentsManager::getLFOFMUsers(int lfoNum) const
+InstrumentUserSet InstrumentsManager::getLFOFMUsers(int lfoNum) const
 {
-	return lfoFM_.at(lfoNum)->getUserInstruments();
+	return lfoFM_.get(lfoNum)->getUserInstruments();
 }
 
 std::vector<int> InstrumentsManager::getLFOFMEntriedIndices() const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& lfo : lfoFM_) {
-		if (lfo->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < lfoFM_.size(); ++i) {
+		if (lfoFM_.get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -684,7 +756,7 @@ std::vector<int> InstrumentsManager::getLFOFMEntriedIndices() const
 int InstrumentsManager::findFirstFreeLFOFM() const
 {
 	for (size_t i = 0; i < lfoFM_.size(); ++i) {
-		if (!lfoFM_[i]->isUserInstrument()) return i;
+		if (!lfoFM_.get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -692,7 +764,7 @@ int InstrumentsManager::findFirstFreeLFOFM() const
 int InstrumentsManager::findFirstFreePlainLFOFM() const
 {
 	for (size_t i = 0; i < lfoFM_.size(); ++i) {
-		if (!lfoFM_[i]->isUserInstrument() && !lfoFM_[i]->isEdited()) return i;
+		if (!lfoFM_.get(i)->isUserInstrument() && !lfoFM_.get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -705,6 +777,7 @@ void InstrumentsManager::setInstrumentFMOperatorSequenceEnabled(int instNum, FME
 		opSeqFM_.at(param).at(fm->getOperatorSequenceNumber(param))->registerUserInstrument(instNum);
 	else
 		opSeqFM_.at(param).at(fm->getOperatorSequenceNumber(param))->deregisterUserInstrument(instNum);
+	publishInstrument(instNum);
 }
 
 bool InstrumentsManager::getInstrumentFMOperatorSequenceEnabled(int instNum, FMEnvelopeParameter param) const
@@ -720,6 +793,7 @@ void InstrumentsManager::setInstrumentFMOperatorSequence(int instNum, FMEnvelope
 		opSeqFM_.at(param).at(opSeqNum)->registerUserInstrument(instNum);
 	}
 	fm->setOperatorSequenceNumber(param, opSeqNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentFMOperatorSequence(int instNum, FMEnvelopeParameter param)
@@ -742,9 +816,9 @@ void InstrumentsManager::setOperatorSequenceFMSequenceCommand(FMEnvelopeParamete
 	opSeqFM_.at(param).at(opSeqNum)->setSequenceCommand(cnt, type, data);
 }
 
-std::vector<CommandInSequence> InstrumentsManager::getOperatorSequenceFMSequence(FMEnvelopeParameter param, int opSeqNum)
+const std::vector<CommandInSequence>& InstrumentsManager::getOperatorSequenceFMSequence(FMEnvelopeParameter param, int opSeqNum)
 {
-	return opSeqFM_.at(param).at(opSeqNum)->getSequence();
+	return opSeqFM_.at(param).get(opSeqNum)->getSequence();
 }
 
 void InstrumentsManager::setOperatorSequenceFMLoops(FMEnvelopeParameter param, int opSeqNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times)
@@ -752,9 +826,9 @@ void InstrumentsManager::setOperatorSequenceFMLoops(FMEnvelopeParameter param, i
 	opSeqFM_.at(param).at(opSeqNum)->setLoops(std::move(begins), std::move(ends), std::move(times));
 }
 
-std::vector<Loop> InstrumentsManager::getOperatorSequenceFMLoops(FMEnvelopeParameter param, int opSeqNum) const
+const std::vector<Loop>& InstrumentsManager::getOperatorSequenceFMLoops(FMEnvelopeParameter param, int opSeqNum) const
 {
-	return opSeqFM_.at(param).at(opSeqNum)->getLoops();
+	return opSeqFM_.at(param).get(opSeqNum)->getLoops();
 }
 
 void InstrumentsManager::setOperatorSequenceFMRelease(FMEnvelopeParameter param, int opSeqNum, ReleaseType type, int begin)
@@ -764,26 +838,29 @@ void InstrumentsManager::setOperatorSequenceFMRelease(FMEnvelopeParameter param,
 
 Release InstrumentsManager::getOperatorSequenceFMRelease(FMEnvelopeParameter param, int opSeqNum) const
 {
-	return opSeqFM_.at(param).at(opSeqNum)->getRelease();
+	return opSeqFM_.at(param).get(opSeqNum)->getRelease();
+}
+
+uint64_t InstrumentsManager::getOperatorSequenceFMVersion(FMEnvelopeParameter param, int opSeqNum) const
+{
+	return opSeqFM_.at(param).get(opSeqNum)->getVersion();
 }
 
 std::unique_ptr<CommandSequence::Iterator> InstrumentsManager::getOperatorSequenceFMIterator(FMEnvelopeParameter param, int opSeqNum) const
 {
-	return opSeqFM_.at(param).at(opSeqNum)->getIterator();
+	return opSeqFM_.at(param).get(opSeqNum)->getIterator();
 }
 
-std::vector<int> InstrumentsManager::getOperatorSequenceFMUsers(FMEnvelopeParameter param, int opSeqNum) const
+InstrumentUserSet InstrumentsManager::getOperatorSequenceFMUsers(FMEnvelopeParameter param, int opSeqNum) const
 {
-	return opSeqFM_.at(param).at(opSeqNum)->getUserInstruments();
+	return opSeqFM_.at(param).get(opSeqNum)->getUserInstruments();
 }
 
 std::vector<int> InstrumentsManager::getOperatorSequenceFMEntriedIndices(FMEnvelopeParameter param) const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& seq : opSeqFM_.at(param)) {
-		if (seq->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < opSeqFM_.at(param).size(); ++i) {
+		if (opSeqFM_.at(param).get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -791,7 +868,7 @@ std::vector<int> InstrumentsManager::getOperatorSequenceFMEntriedIndices(FMEnvel
 int InstrumentsManager::findFirstFreeOperatorSequenceFM(FMEnvelopeParameter param) const
 {
 	for (size_t i = 0; i < opSeqFM_.at(param).size(); ++i) {
-		if (!opSeqFM_.at(param)[i]->isUserInstrument()) return i;
+		if (!opSeqFM_.at(param).get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -799,7 +876,7 @@ int InstrumentsManager::findFirstFreeOperatorSequenceFM(FMEnvelopeParameter para
 int InstrumentsManager::findFirstFreePlainOperatorSequenceFM(FMEnvelopeParameter param) const
 {
 	for (size_t i = 0; i < opSeqFM_.at(param).size(); ++i) {
-		if (!opSeqFM_.at(param)[i]->isUserInstrument() && !opSeqFM_.at(param)[i]->isEdited()) return i;
+		if (!opSeqFM_.at(param).get(i)->isUserInstrument() && !opSeqFM_.at(param).get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -812,6 +889,7 @@ void InstrumentsManager::setInstrumentFMArpeggioEnabled(int instNum, bool enable
 		arpFM_.at(fm->getArpeggioNumber())->registerUserInstrument(instNum);
 	else
 		arpFM_.at(fm->getArpeggioNumber())->deregisterUserInstrument(instNum);
+	publishInstrument(instNum);
 }
 
 bool InstrumentsManager::getInstrumentFMArpeggioEnabled(int instNum) const
@@ -827,6 +905,7 @@ void InstrumentsManager::setInstrumentFMArpeggio(int instNum, int arpNum)
 		arpFM_.at(arpNum)->registerUserInstrument(instNum);
 	}
 	fm->setArpeggioNumber(arpNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentFMArpeggio(int instNum)
@@ -841,7 +920,7 @@ void InstrumentsManager::setArpeggioFMType(int arpNum, int type)
 
 int InstrumentsManager::getArpeggioFMType(int arpNum) const
 {
-	return arpFM_.at(arpNum)->getType();
+	return arpFM_.get(arpNum)->getType();
 }
 
 void InstrumentsManager::addArpeggioFMSequenceCommand(int arpNum, int type, int data)
@@ -859,9 +938,9 @@ void InstrumentsManager::setArpeggioFMSequenceCommand(int arpNum, int cnt, int t
 	arpFM_.at(arpNum)->setSequenceCommand(cnt, type, data);
 }
 
-std::vector<CommandInSequence> InstrumentsManager::getArpeggioFMSequence(int arpNum)
+const std::vector<CommandInSequence>& InstrumentsManager::getArpeggioFMSequence(int arpNum)
 {
-	return arpFM_.at(arpNum)->getSequence();
+	return arpFM_.get(arpNum)->getSequence();
 }
 
 void InstrumentsManager::setArpeggioFMLoops(int arpNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times)
@@ -869,9 +948,9 @@ void InstrumentsManager::setArpeggioFMLoops(int arpNum, std::vector<int> begins,
 	arpFM_.at(arpNum)->setLoops(std::move(begins), std::move(ends), std::move(times));
 }
 
-std::vector<Loop> InstrumentsManager::getArpeggioFMLoops(int arpNum) const
+const std::vector<Loop>& InstrumentsManager::getArpeggioFMLoops(int arpNum) const
 {
-	return arpFM_.at(arpNum)->getLoops();
+	return arpFM_.get(arpNum)->getLoops();
 }
 
 void InstrumentsManager::setArpeggioFMRelease(int arpNum, ReleaseType type, int begin)
@@ -881,26 +960,29 @@ void InstrumentsManager::setArpeggioFMRelease(int arpNum, ReleaseType type, int
 
 Release InstrumentsManager::getArpeggioFMRelease(int arpNum) const
 {
-	return arpFM_.at(arpNum)->getRelease();
+	return arpFM_.get(arpNum)->getRelease();
+}
+
+uint64_t InstrumentsManager::getArpeggioFMVersion(int arpNum) const
+{
+	return arpFM_.get(arpNum)->getVersion();
 }
 
 std::unique_ptr<CommandSequence::Iterator> InstrumentsManager::getArpeggioFMIterator(int arpNum) const
 {
-	return arpFM_.at(arpNum)->getIterator();
+	return arpFM_.get(arpNum)->getIterator();
 }
 
-std::vector<int> InstrumentsManager::getArpeggioFMUsers(int arpNum) const
+InstrumentUserSet InstrumentsManager::getArpeggioFMUsers(int arpNum) const
 {
-	return arpFM_.at(arpNum)->getUserInstruments();
+	return arpFM_.get(arpNum)->getUserInstruments();
 }
 
 std::vector<int> InstrumentsManager::getArpeggioFMEntriedIndices() const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& arp : arpFM_) {
-		if (arp->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < arpFM_.size(); ++i) {
+		if (arpFM_.get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -908,7 +990,7 @@ std::vector<int> InstrumentsManager::getArpeggioFMEntriedIndices() const
 int InstrumentsManager::findFirstFreeArpeggioFM() const
 {
 	for (size_t i = 0; i < arpFM_.size(); ++i) {
-		if (!arpFM_[i]->isUserInstrument()) return i;
+		if (!arpFM_.get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -916,7 +998,7 @@ int InstrumentsManager::findFirstFreeArpeggioFM() const
 int InstrumentsManager::findFirstFreePlainArpeggioFM() const
 {
 	for (size_t i = 0; i < arpFM_.size(); ++i) {
-		if (!arpFM_[i]->isUserInstrument() && !arpFM_[i]->isEdited()) return i;
+		if (!arpFM_.get(i)->isUserInstrument() && !arpFM_.get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -929,6 +1011,7 @@ void InstrumentsManager::setInstrumentFMPitchEnabled(int instNum, bool enabled)
 		ptFM_.at(fm->getPitchNumber())->registerUserInstrument(instNum);
 	else
 		ptFM_.at(fm->getPitchNumber())->deregisterUserInstrument(instNum);
+	publishInstrument(instNum);
 }
 
 bool InstrumentsManager::getInstrumentFMPitchEnabled(int instNum) const
@@ -944,6 +1027,7 @@ void InstrumentsManager::setInstrumentFMPitch(int instNum, int ptNum)
 		ptFM_.at(ptNum)->registerUserInstrument(instNum);
 	}
 	fm->setPitchNumber(ptNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentFMPitch(int instNum)
@@ -958,7 +1042,7 @@ void InstrumentsManager::setPitchFMType(int ptNum, int type)
 
 int InstrumentsManager::getPitchFMType(int ptNum) const
 {
-	return ptFM_.at(ptNum)->getType();
+	return ptFM_.get(ptNum)->getType();
 }
 
 void InstrumentsManager::addPitchFMSequenceCommand(int ptNum, int type, int data)
@@ -976,9 +1060,9 @@ void InstrumentsManager::setPitchFMSequenceCommand(int ptNum, int cnt, int type,
 	ptFM_.at(ptNum)->setSequenceCommand(cnt, type, data);
 }
 
-std::vector<CommandInSequence> InstrumentsManager::getPitchFMSequence(int ptNum)
+const std::vector<CommandInSequence>& InstrumentsManager::getPitchFMSequence(int ptNum)
 {
-	return ptFM_.at(ptNum)->getSequence();
+	return ptFM_.get(ptNum)->getSequence();
 }
 
 void InstrumentsManager::setPitchFMLoops(int ptNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times)
@@ -986,9 +1070,9 @@ void InstrumentsManager::setPitchFMLoops(int ptNum, std::vector<int> begins, std
 	ptFM_.at(ptNum)->setLoops(std::move(begins), std::move(ends), std::move(times));
 }
 
-std::vector<Loop> InstrumentsManager::getPitchFMLoops(int ptNum) const
+const std::vector<Loop>& InstrumentsManager::getPitchFMLoops(int ptNum) const
 {
-	return ptFM_.at(ptNum)->getLoops();
+	return ptFM_.get(ptNum)->getLoops();
 }
 
 void InstrumentsManager::setPitchFMRelease(int ptNum, ReleaseType type, int begin)
@@ -998,31 +1082,35 @@ void InstrumentsManager::setPitchFMRelease(int ptNum, ReleaseType type, int begi
 
 Release InstrumentsManager::getPitchFMRelease(int ptNum) const
 {
-	return ptFM_.at(ptNum)->getRelease();
+	return ptFM_.get(ptNum)->getRelease();
+}
+
+uint64_t InstrumentsManager::getPitchFMVersion(int ptNum) const
+{
+	return ptFM_.get(ptNum)->getVersion();
 }
 
 std::unique_ptr<CommandSequence::Iterator> InstrumentsManager::getPitchFMIterator(int ptNum) const
 {
-	return ptFM_.at(ptNum)->getIterator();
+	return ptFM_.get(ptNum)->getIterator();
 }
 
-std::vector<int> InstrumentsManager::getPitchFMUsers(int ptNum) const
+InstrumentUserSet InstrumentsManager::getPitchFMUsers(int ptNum) const
 {
-	return ptFM_.at(ptNum)->getUserInstruments();
+	return ptFM_.get(ptNum)->getUserInstruments();
 }
 
 void InstrumentsManager::setInstrumentFMEnvelopeResetEnabled(int instNum, bool enabled)
 {
 	std::dynamic_pointer_cast<InstrumentFM>(insts_[instNum])->setEnvelopeResetEnabled(enabled);
+	publishInstrument(instNum);
 }
 
 std::vector<int> InstrumentsManager::getPitchFMEntriedIndices() const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& pt : ptFM_) {
-		if (pt->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < ptFM_.size(); ++i) {
+		if (ptFM_.get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -1030,7 +1118,7 @@ std::vector<int> InstrumentsManager::getPitchFMEntriedIndices() const
 int InstrumentsManager::findFirstFreePitchFM() const
 {
 	for (size_t i = 0; i < ptFM_.size(); ++i) {
-		if (!ptFM_[i]->isUserInstrument()) return i;
+		if (!ptFM_.get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -1038,7 +1126,7 @@ int InstrumentsManager::findFirstFreePitchFM() const
 int InstrumentsManager::findFirstFreePlainPitchFM() const
 {
 	for (size_t i = 0; i < ptFM_.size(); ++i) {
-		if (!ptFM_[i]->isUserInstrument() && !ptFM_[i]->isEdited()) return i;
+		if (!ptFM_.get(i)->isUserInstrument() && !ptFM_.get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -1052,6 +1140,7 @@ void InstrumentsManager::setInstrumentSSGWaveFormEnabled(int instNum, bool enabl
 		wfSSG_.at(ssg->getWaveFormNumber())->registerUserInstrument(instNum);
 	else
 		wfSSG_.at(ssg->getWaveFormNumber())->deregisterUserInstrument(instNum);
+	publishInstrument(instNum);
 }
 
 bool InstrumentsManager::getInstrumentSSGWaveFormEnabled(int instNum) const
@@ -1067,6 +1156,7 @@ void InstrumentsManager::setInstrumentSSGWaveForm(int instNum, int wfNum)
 		wfSSG_.at(wfNum)->registerUserInstrument(instNum);
 	}
 	ssg->setWaveFormNumber(wfNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentSSGWaveForm(int instNum)
@@ -1089,9 +1179,9 @@ void InstrumentsManager::setWaveFormSSGSequenceCommand(int wfNum, int cnt, int t
 	wfSSG_.at(wfNum)->setSequenceCommand(cnt, type, data);
 }
 
-std::vector<CommandInSequence> InstrumentsManager::getWaveFormSSGSequence(int wfNum)
+const std::vector<CommandInSequence>& InstrumentsManager::getWaveFormSSGSequence(int wfNum)
 {
-	return wfSSG_.at(wfNum)->getSequence();
+	return wfSSG_.get(wfNum)->getSequence();
 }
 
 void InstrumentsManager::setWaveFormSSGLoops(int wfNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times)
@@ -1099,9 +1189,9 @@ void InstrumentsManager::setWaveFormSSGLoops(int wfNum, std::vector<int> begins,
 	wfSSG_.at(wfNum)->setLoops(std::move(begins), std::move(ends), std::move(times));
 }
 
-std::vector<Loop> InstrumentsManager::getWaveFormSSGLoops(int wfNum) const
+const std::vector<Loop>& InstrumentsManager::getWaveFormSSGLoops(int wfNum) const
 {
-	return wfSSG_.at(wfNum)->getLoops();
+	return wfSSG_.get(wfNum)->getLoops();
 }
 
 void InstrumentsManager::setWaveFormSSGRelease(int wfNum, ReleaseType type, int begin)
@@ -1111,26 +1201,29 @@ void InstrumentsManager::setWaveFormSSGRelease(int wfNum, ReleaseType type, int
 
 Release InstrumentsManager::getWaveFormSSGRelease(int wfNum) const
 {
-	return wfSSG_.at(wfNum)->getRelease();
+	return wfSSG_.get(wfNum)->getRelease();
+}
+
+uint64_t InstrumentsManager::getWaveFormSSGVersion(int wfNum) const
+{
+	return wfSSG_.get(wfNum)->getVersion();
 }
 
 std::unique_ptr<CommandSequence::Iterator> InstrumentsManager::getWaveFormSSGIterator(int wfNum) const
 {
-	return wfSSG_.at(wfNum)->getIterator();
+	return wfSSG_.get(wfNum)->getIterator();
 }
 
-std::vector<int> InstrumentsManager::getWaveFormSSGUsers(int wfNum) const
+InstrumentUserSet InstrumentsManager::getWaveFormSSGUsers(int wfNum) const
 {
-	return wfSSG_.at(wfNum)->getUserInstruments();
+	return wfSSG_.get(wfNum)->getUserInstruments();
 }
 
 std::vector<int> InstrumentsManager::getWaveFormSSGEntriedIndices() const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& wf : wfSSG_) {
-		if (wf->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < wfSSG_.size(); ++i) {
+		if (wfSSG_.get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -1138,7 +1231,7 @@ std::vector<int> InstrumentsManager::getWaveFormSSGEntriedIndices() const
 int InstrumentsManager::findFirstFreeWaveFormSSG() const
 {
 	for (size_t i = 0; i < wfSSG_.size(); ++i) {
-		if (!wfSSG_[i]->isUserInstrument()) return i;
+		if (!wfSSG_.get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -1146,7 +1239,7 @@ int InstrumentsManager::findFirstFreeWaveFormSSG() const
 int InstrumentsManager::findFirstFreePlainWaveFormSSG() const
 {
 	for (size_t i = 0; i < wfSSG_.size(); ++i) {
-		if (!wfSSG_[i]->isUserInstrument() && !wfSSG_[i]->isEdited()) return i;
+		if (!wfSSG_.get(i)->isUserInstrument() && !wfSSG_.get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -1159,6 +1252,7 @@ void InstrumentsManager::setInstrumentSSGToneNoiseEnabled(int instNum, bool enab
 		tnSSG_.at(ssg->getToneNoiseNumber())->registerUserInstrument(instNum);
 	else
 		tnSSG_.at(ssg->getToneNoiseNumber())->deregisterUserInstrument(instNum);
+	publishInstrument(instNum);
 }
 
 bool InstrumentsManager::getInstrumentSSGToneNoiseEnabled(int instNum) const
@@ -1174,6 +1268,7 @@ void InstrumentsManager::setInstrumentSSGToneNoise(int instNum, int tnNum)
 		tnSSG_.at(tnNum)->registerUserInstrument(instNum);
 	}
 	ssg->setToneNoiseNumber(tnNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentSSGToneNoise(int instNum)
@@ -1196,9 +1291,9 @@ void InstrumentsManager::setToneNoiseSSGSequenceCommand(int tnNum, int cnt, int
 	tnSSG_.at(tnNum)->setSequenceCommand(cnt, type, data);
 }
 
-std::vector<CommandInSequence> InstrumentsManager::getToneNoiseSSGSequence(int tnNum)
+const std::vector<CommandInSequence>& InstrumentsManager::getToneNoiseSSGSequence(int tnNum)
 {
-	return tnSSG_.at(tnNum)->getSequence();
+	return tnSSG_.get(tnNum)->getSequence();
 }
 
 void InstrumentsManager::setToneNoiseSSGLoops(int tnNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times)
@@ -1206,9 +1301,9 @@ void InstrumentsManager::setToneNoiseSSGLoops(int tnNum, std::vector<int> begins
 	tnSSG_.at(tnNum)->setLoops(std::move(begins), std::move(ends), std::move(times));
 }
 
-std::vector<Loop> InstrumentsManager::getToneNoiseSSGLoops(int tnNum) const
+const std::vector<Loop>& InstrumentsManager::getToneNoiseSSGLoops(int tnNum) const
 {
-	return tnSSG_.at(tnNum)->getLoops();
+	return tnSSG_.get(tnNum)->getLoops();
 }
 
 void InstrumentsManager::setToneNoiseSSGRelease(int tnNum, ReleaseType type, int begin)
@@ -1218,26 +1313,29 @@ void InstrumentsManager::setToneNoiseSSGRelease(int tnNum, ReleaseType type, int
 
 Release InstrumentsManager::getToneNoiseSSGRelease(int tnNum) const
 {
-	return tnSSG_.at(tnNum)->getRelease();
+	return tnSSG_.get(tnNum)->getRelease();
+}
+
+uint64_t InstrumentsManager::getToneNoiseSSGVersion(int tnNum) const
+{
+	return tnSSG_.get(tnNum)->getVersion();
 }
 
 std::unique_ptr<CommandSequence::Iterator> InstrumentsManager::getToneNoiseSSGIterator(int tnNum) const
 {
-	return tnSSG_.at(tnNum)->getIterator();
+	return tnSSG_.get(tnNum)->getIterator();
 }
 
-std::vector<int> InstrumentsManager::getToneNoiseSSGUsers(int tnNum) const
+InstrumentUserSet InstrumentsManager::getToneNoiseSSGUsers(int tnNum) const
 {
-	return tnSSG_.at(tnNum)->getUserInstruments();
+	return tnSSG_.get(tnNum)->getUserInstruments();
 }
 
 std::vector<int> InstrumentsManager::getToneNoiseSSGEntriedIndices() const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& tn : tnSSG_) {
-		if (tn->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < tnSSG_.size(); ++i) {
+		if (tnSSG_.get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -1245,7 +1343,7 @@ std::vector<int> InstrumentsManager::getToneNoiseSSGEntriedIndices() const
 int InstrumentsManager::findFirstFreeToneNoiseSSG() const
 {
 	for (size_t i = 0; i < tnSSG_.size(); ++i) {
-		if (!tnSSG_[i]->isUserInstrument()) return i;
+		if (!tnSSG_.get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -1253,7 +1351,7 @@ int InstrumentsManager::findFirstFreeToneNoiseSSG() const
 int InstrumentsManager::findFirstFreePlainToneNoiseSSG() const
 {
 	for (size_t i = 0; i < tnSSG_.size(); ++i) {
-		if (!tnSSG_[i]->isUserInstrument() && !tnSSG_[i]->isEdited()) return i;
+		if (!tnSSG_.get(i)->isUserInstrument() && !tnSSG_.get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -1266,6 +1364,7 @@ void InstrumentsManager::setInstrumentSSGEnvelopeEnabled(int instNum, bool enabl
 		envSSG_.at(ssg->getEnvelopeNumber())->registerUserInstrument(instNum);
 	else
 		envSSG_.at(ssg->getEnvelopeNumber())->deregisterUserInstrument(instNum);
+	publishInstrument(instNum);
 }
 
 bool InstrumentsManager::getInstrumentSSGEnvelopeEnabled(int instNum) const
@@ -1281,6 +1380,7 @@ void InstrumentsManager::setInstrumentSSGEnvelope(int instNum, int envNum)
 		envSSG_.at(envNum)->registerUserInstrument(instNum);
 	}
 	ssg->setEnvelopeNumber(envNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentSSGEnvelope(int instNum)
@@ -1303,9 +1403,9 @@ void InstrumentsManager::setEnvelopeSSGSequenceCommand(int envNum, int cnt, int
 	envSSG_.at(envNum)->setSequenceCommand(cnt, type, data);
 }
 
-std::vector<CommandInSequence> InstrumentsManager::getEnvelopeSSGSequence(int envNum)
+const std::vector<CommandInSequence>& InstrumentsManager::getEnvelopeSSGSequence(int envNum)
 {
-	return envSSG_.at(envNum)->getSequence();
+	return envSSG_.get(envNum)->getSequence();
 }
 
 void InstrumentsManager::setEnvelopeSSGLoops(int envNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times)
@@ -1313,9 +1413,9 @@ void InstrumentsManager::setEnvelopeSSGLoops(int envNum, std::vector<int> begins
 	envSSG_.at(envNum)->setLoops(std::move(begins), std::move(ends), std::move(times));
 }
 
-std::vector<Loop> InstrumentsManager::getEnvelopeSSGLoops(int envNum) const
+const std::vector<Loop>& InstrumentsManager::getEnvelopeSSGLoops(int envNum) const
 {
-	return envSSG_.at(envNum)->getLoops();
+	return envSSG_.get(envNum)->getLoops();
 }
 
 void InstrumentsManager::setEnvelopeSSGRelease(int envNum, ReleaseType type, int begin)
@@ -1325,26 +1425,29 @@ void InstrumentsManager::setEnvelopeSSGRelease(int envNum, ReleaseType type, int
 
 Release InstrumentsManager::getEnvelopeSSGRelease(int envNum) const
 {
-	return envSSG_.at(envNum)->getRelease();
+	return envSSG_.get(envNum)->getRelease();
+}
+
+uint64_t InstrumentsManager::getEnvelopeSSGVersion(int envNum) const
+{
+	return envSSG_.get(envNum)->getVersion();
 }
 
 std::unique_ptr<CommandSequence::Iterator> InstrumentsManager::getEnvelopeSSGIterator(int envNum) const
 {
-	return envSSG_.at(envNum)->getIterator();
+	return envSSG_.get(envNum)->getIterator();
 }
 
-std::vector<int> InstrumentsManager::getEnvelopeSSGUsers(int envNum) const
+InstrumentUserSet InstrumentsManager::getEnvelopeSSGUsers(int envNum) const
 {
-	return envSSG_.at(envNum)->getUserInstruments();
+	return envSSG_.get(envNum)->getUserInstruments();
 }
 
 std::vector<int> InstrumentsManager::getEnvelopeSSGEntriedIndices() const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& env : envSSG_) {
-		if (env->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < envSSG_.size(); ++i) {
+		if (envSSG_.get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -1352,7 +1455,7 @@ std::vector<int> InstrumentsManager::getEnvelopeSSGEntriedIndices() const
 int InstrumentsManager::findFirstFreeEnvelopeSSG() const
 {
 	for (size_t i = 0; i < envSSG_.size(); ++i) {
-		if (!envSSG_[i]->isUserInstrument()) return i;
+		if (!envSSG_.get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -1360,7 +1463,7 @@ int InstrumentsManager::findFirstFreeEnvelopeSSG() const
 int InstrumentsManager::findFirstFreePlainEnvelopeSSG() const
 {
 	for (size_t i = 0; i < envSSG_.size(); ++i) {
-		if (!envSSG_[i]->isUserInstrument() && !envSSG_[i]->isEdited()) return i;
+		if (!envSSG_.get(i)->isUserInstrument() && !envSSG_.get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -1373,6 +1476,7 @@ void InstrumentsManager::setInstrumentSSGArpeggioEnabled(int instNum, bool enabl
 		arpSSG_.at(ssg->getArpeggioNumber())->registerUserInstrument(instNum);
 	else
 		arpSSG_.at(ssg->getArpeggioNumber())->deregisterUserInstrument(instNum);
+	publishInstrument(instNum);
 }
 
 bool InstrumentsManager::getInstrumentSSGArpeggioEnabled(int instNum) const
@@ -1388,6 +1492,7 @@ void InstrumentsManager::setInstrumentSSGArpeggio(int instNum, int arpNum)
 		arpSSG_.at(arpNum)->registerUserInstrument(instNum);
 	}
 	ssg->setArpeggioNumber(arpNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentSSGArpeggio(int instNum)
@@ -1402,7 +1507,7 @@ void InstrumentsManager::setArpeggioSSGType(int arpNum, int type)
 
 int InstrumentsManager::getArpeggioSSGType(int arpNum) const
 {
-	return arpSSG_.at(arpNum)->getType();
+	return arpSSG_.get(arpNum)->getType();
 }
 
 void InstrumentsManager::addArpeggioSSGSequenceCommand(int arpNum, int type, int data)
@@ -1420,9 +1525,9 @@ void InstrumentsManager::setArpeggioSSGSequenceCommand(int arpNum, int cnt, int
 	arpSSG_.at(arpNum)->setSequenceCommand(cnt, type, data);
 }
 
-std::vector<CommandInSequence> InstrumentsManager::getArpeggioSSGSequence(int arpNum)
+const std::vector<CommandInSequence>& InstrumentsManager::getArpeggioSSGSequence(int arpNum)
 {
-	return arpSSG_.at(arpNum)->getSequence();
+	return arpSSG_.get(arpNum)->getSequence();
 }
 
 void InstrumentsManager::setArpeggioSSGLoops(int arpNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times)
@@ -1430,9 +1535,9 @@ void InstrumentsManager::setArpeggioSSGLoops(int arpNum, std::vector<int> begins
 	arpSSG_.at(arpNum)->setLoops(std::move(begins), std::move(ends), std::move(times));
 }
 
-std::vector<Loop> InstrumentsManager::getArpeggioSSGLoops(int arpNum) const
+const std::vector<Loop>& InstrumentsManager::getArpeggioSSGLoops(int arpNum) const
 {
-	return arpSSG_.at(arpNum)->getLoops();
+	return arpSSG_.get(arpNum)->getLoops();
 }
 
 void InstrumentsManager::setArpeggioSSGRelease(int arpNum, ReleaseType type, int begin)
@@ -1442,26 +1547,29 @@ void InstrumentsManager::setArpeggioSSGRelease(int arpNum, ReleaseType type, int
 
 Release InstrumentsManager::getArpeggioSSGRelease(int arpNum) const
 {
-	return arpSSG_.at(arpNum)->getRelease();
+	return arpSSG_.get(arpNum)->getRelease();
+}
+
+uint64_t InstrumentsManager::getArpeggioSSGVersion(int arpNum) const
+{
+	return arpSSG_.get(arpNum)->getVersion();
 }
 
 std::unique_ptr<CommandSequence::Iterator> InstrumentsManager::getArpeggioSSGIterator(int arpNum) const
 {
-	return arpSSG_.at(arpNum)->getIterator();
+	return arpSSG_.get(arpNum)->getIterator();
 }
 
-std::vector<int> InstrumentsManager::getArpeggioSSGUsers(int arpNum) const
+InstrumentUserSet InstrumentsManager::getArpeggioSSGUsers(int arpNum) const
 {
-	return arpSSG_.at(arpNum)->getUserInstruments();
+	return arpSSG_.get(arpNum)->getUserInstruments();
 }
 
 std::vector<int> InstrumentsManager::getArpeggioSSGEntriedIndices() const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& arp : arpSSG_) {
-		if (arp->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < arpSSG_.size(); ++i) {
+		if (arpSSG_.get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -1469,7 +1577,7 @@ std::vector<int> InstrumentsManager::getArpeggioSSGEntriedIndices() const
 int InstrumentsManager::findFirstFreeArpeggioSSG() const
 {
 	for (size_t i = 0; i < arpSSG_.size(); ++i) {
-		if (!arpSSG_[i]->isUserInstrument()) return i;
+		if (!arpSSG_.get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -1477,7 +1585,7 @@ int InstrumentsManager::findFirstFreeArpeggioSSG() const
 int InstrumentsManager::findFirstFreePlainArpeggioSSG() const
 {
 	for (size_t i = 0; i < arpSSG_.size(); ++i) {
-		if (!arpSSG_[i]->isUserInstrument() && !arpSSG_[i]->isEdited()) return i;
+		if (!arpSSG_.get(i)->isUserInstrument() && !arpSSG_.get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -1490,6 +1598,7 @@ void InstrumentsManager::setInstrumentSSGPitchEnabled(int instNum, bool enabled)
 		ptSSG_.at(ssg->getPitchNumber())->registerUserInstrument(instNum);
 	else
 		ptSSG_.at(ssg->getPitchNumber())->deregisterUserInstrument(instNum);
+	publishInstrument(instNum);
 }
 
 bool InstrumentsManager::getInstrumentSSGPitchEnabled(int instNum) const
@@ -1505,6 +1614,7 @@ void InstrumentsManager::setInstrumentSSGPitch(int instNum, int ptNum)
 		ptSSG_.at(ptNum)->registerUserInstrument(instNum);
 	}
 	ssg->setPitchNumber(ptNum);
+	publishInstrument(instNum);
 }
 
 int InstrumentsManager::getInstrumentSSGPitch(int instNum)
@@ -1519,7 +1629,7 @@ void InstrumentsManager::setPitchSSGType(int ptNum, int type)
 
 int InstrumentsManager::getPitchSSGType(int ptNum) const
 {
-	return ptSSG_.at(ptNum)->getType();
+	return ptSSG_.get(ptNum)->getType();
 }
 
 void InstrumentsManager::addPitchSSGSequenceCommand(int ptNum, int type, int data)
@@ -1537,9 +1647,9 @@ void InstrumentsManager::setPitchSSGSequenceCommand(int ptNum, int cnt, int type
 	ptSSG_.at(ptNum)->setSequenceCommand(cnt, type, data);
 }
 
-std::vector<CommandInSequence> InstrumentsManager::getPitchSSGSequence(int ptNum)
+const std::vector<CommandInSequence>& InstrumentsManager::getPitchSSGSequence(int ptNum)
 {
-	return ptSSG_.at(ptNum)->getSequence();
+	return ptSSG_.get(ptNum)->getSequence();
 }
 
 void InstrumentsManager::setPitchSSGLoops(int ptNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times)
@@ -1547,9 +1657,9 @@ void InstrumentsManager::setPitchSSGLoops(int ptNum, std::vector<int> begins, st
 	ptSSG_.at(ptNum)->setLoops(std::move(begins), std::move(ends), std::move(times));
 }
 
-std::vector<Loop> InstrumentsManager::getPitchSSGLoops(int ptNum) const
+const std::vector<Loop>& InstrumentsManager::getPitchSSGLoops(int ptNum) const
 {
-	return ptSSG_.at(ptNum)->getLoops();
+	return ptSSG_.get(ptNum)->getLoops();
 }
 
 void InstrumentsManager::setPitchSSGRelease(int ptNum, ReleaseType type, int begin)
@@ -1559,26 +1669,29 @@ void InstrumentsManager::setPitchSSGRelease(int ptNum, ReleaseType type, int beg
 
 Release InstrumentsManager::getPitchSSGRelease(int ptNum) const
 {
-	return ptSSG_.at(ptNum)->getRelease();
+	return ptSSG_.get(ptNum)->getRelease();
+}
+
+uint64_t InstrumentsManager::getPitchSSGVersion(int ptNum) const
+{
+	return ptSSG_.get(ptNum)->getVersion();
 }
 
 std::unique_ptr<CommandSequence::Iterator> InstrumentsManager::getPitchSSGIterator(int ptNum) const
 {
-	return ptSSG_.at(ptNum)->getIterator();
+	return ptSSG_.get(ptNum)->getIterator();
 }
 
-std::vector<int> InstrumentsManager::getPitchSSGUsers(int ptNum) const
+InstrumentUserSet InstrumentsManager::getPitchSSGUsers(int ptNum) const
 {
-	return ptSSG_.at(ptNum)->getUserInstruments();
+	return ptSSG_.get(ptNum)->getUserInstruments();
 }
 
 std::vector<int> InstrumentsManager::getPitchSSGEntriedIndices() const
 {
 	std::vector<int> idcs;
-	int n = 0;
-	for (auto& pt : ptSSG_) {
-		if (pt->isEdited()) idcs.push_back(n);
-		++n;
+	for (size_t i = 0; i < ptSSG_.size(); ++i) {
+		if (ptSSG_.get(i)->isEdited()) idcs.push_back(i);
 	}
 	return idcs;
 }
@@ -1586,7 +1699,7 @@ std::vector<int> InstrumentsManager::getPitchSSGEntriedIndices() const
 int InstrumentsManager::findFirstFreePitchSSG() const
 {
 	for (size_t i = 0; i < ptSSG_.size(); ++i) {
-		if (!ptSSG_[i]->isUserInstrument()) return i;
+		if (!ptSSG_.get(i)->isUserInstrument()) return i;
 	}
 	return -1;
 }
@@ -1594,7 +1707,7 @@ int InstrumentsManager::findFirstFreePitchSSG() const
 int InstrumentsManager::findFirstFreePlainPitchSSG() const
 {
 	for (size_t i = 0; i < ptSSG_.size(); ++i) {
-		if (!ptSSG_[i]->isUserInstrument() && !ptSSG_[i]->isEdited()) return i;
+		if (!ptSSG_.get(i)->isUserInstrument() && !ptSSG_.get(i)->isEdited()) return i;
 	}
 	return -1;
 }
@@ -9,6 +9,7 @@
 #include "envelope_fm.hpp"
 #include "lfo_fm.hpp"
 #include "command_sequence.hpp"
+#include "instrument_property_table.hpp"
 #include "misc.hpp"
 
 class AbstractInstrument;
@@ -26,6 +27,10 @@ public:
 	void cloneInstrument(int cloneInstNum, int resInstNum);
 	void deepCloneInstrument(int cloneInstNum, int resInstNum);
 	std::shared_ptr<AbstractInstrument> getInstrumentSharedPtr(int instNum);
+	/// Immutable copy of the instrument, replaced as a whole when the instrument is changed.
+	/// Its own fields can be read from another thread without locking,
+	/// but property contents reached through it are shared with the manager and edited in place
+	std::shared_ptr<const AbstractInstrument> getInstrumentSnapshot(int instNum) const;
 	void clearAll();
 	std::vector<int> getInstrumentIndices() const;
 
@@ -35,11 +40,22 @@ public:
 	std::vector<int> getEntriedInstrumentIndices() const;
 
 	void clearUnusedInstrumentProperties();
+	/// Point the properties of the instrument which is not added yet
+	/// to identical ones used by other instruments, and clear its own unused properties
+	void reuseIdenticalProperties(AbstractInstrument* inst);
 
 	int findFirstFreeInstrument() const;
 
 private:
 	std::array<std::shared_ptr<AbstractInstrument>, 128> insts_;
+	std::array<std::shared_ptr<const AbstractInstrument>, 128> snapshots_;
+
+	void publishInstrument(int instNum);
+
+	template <class T>
+	static void clearUnusedProperty(InstrumentPropertyTable<T>& props, int num);
+	template <class T>
+	static int reuseProperty(InstrumentPropertyTable<T>& props, int num);
 
 	//----- FM methods -----
 public:
@@ -49,7 +65,7 @@ public:
 	int getEnvelopeFMParameter(int envNum, FMEnvelopeParameter param) const;
 	void setEnvelopeFMOperatorEnabled(int envNum, int opNum, bool enabled);
 	bool getEnvelopeFMOperatorEnabled(int envNum, int opNum) const;
-	std::vector<int> getEnvelopeFMUsers(int envNum) const;
+	InstrumentUserSet getEnvelopeFMUsers(int envNum) const;
 	std::vector<int> getEnvelopeFMEntriedIndices() const;
 	int findFirstFreeEnvelopeFM() const;
 	int findFirstFreePlainEnvelopeFM() const;
@@ -60,7 +76,7 @@ public:
 	int getInstrumentFMLFO(int instNum) const;
 	void setLFOFMParameter(int lfoNum, FMLFOParameter param, int value);
 	int getLFOFMparameter(int lfoNum, FMLFOParameter param) const;
-	std::vector<int> getLFOFMUsers(int lfoNum) const;
+	InstrumentUserSet getLFOFMUsers(int lfoNum) const;
 	std::vector<int> getLFOFMEntriedIndices() const;
 	int findFirstFreeLFOFM() const;
 	int findFirstFreePlainLFOFM() const;
@@ -72,13 +88,14 @@ public:
 	void addOperatorSequenceFMSequenceCommand(FMEnvelopeParameter param, int opSeqNum, int type, int data);
 	void removeOperatorSequenceFMSequenceCommand(FMEnvelopeParameter param, int opSeqNum);
 	void setOperatorSequenceFMSequenceCommand(FMEnvelopeParameter param, int opSeqNum, int cnt, int type, int data);
-	std::vector<CommandInSequence> getOperatorSequenceFMSequence(FMEnvelopeParameter param, int opSeqNum);
+	const std::vector<CommandInSequence>& getOperatorSequenceFMSequence(FMEnvelopeParameter param, int opSeqNum);
 	void setOperatorSequenceFMLoops(FMEnvelopeParameter param, int opSeqNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times);
-	std::vector<Loop> getOperatorSequenceFMLoops(FMEnvelopeParameter param, int opSeqNum) const;
+	const std::vector<Loop>& getOperatorSequenceFMLoops(FMEnvelopeParameter param, int opSeqNum) const;
 	void setOperatorSequenceFMRelease(FMEnvelopeParameter param, int opSeqNum, ReleaseType type, int begin);
 	Release getOperatorSequenceFMRelease(FMEnvelopeParameter param, int opSeqNum) const;
+	uint64_t getOperatorSequenceFMVersion(FMEnvelopeParameter param, int opSeqNum) const;
 	std::unique_ptr<CommandSequence::Iterator> getOperatorSequenceFMIterator(FMEnvelopeParameter param, int opSeqNum) const;
-	std::vector<int> getOperatorSequenceFMUsers(FMEnvelopeParameter param, int opSeqNum) const;
+	InstrumentUserSet getOperatorSequenceFMUsers(FMEnvelopeParameter param, int opSeqNum) const;
 	std::vector<int> getOperatorSequenceFMEntriedIndices(FMEnvelopeParameter param) const;
 	int findFirstFreeOperatorSequenceFM(FMEnvelopeParameter param) const;
 	int findFirstFreePlainOperatorSequenceFM(FMEnvelopeParameter param) const;
@@ -92,13 +109,14 @@ public:
 	void addArpeggioFMSequenceCommand(int arpNum, int type, int data);
 	void removeArpeggioFMSequenceCommand(int arpNum);
 	void setArpeggioFMSequenceCommand(int arpNum, int cnt, int type, int data);
-	std::vector<CommandInSequence> getArpeggioFMSequence(int arpNum);
+	const std::vector<CommandInSequence>& getArpeggioFMSequence(int arpNum);
 	void setArpeggioFMLoops(int arpNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times);
-	std::vector<Loop> getArpeggioFMLoops(int arpNum) const;
+	const std::vector<Loop>& getArpeggioFMLoops(int arpNum) const;
 	void setArpeggioFMRelease(int arpNum, ReleaseType type, int begin);
 	Release getArpeggioFMRelease(int arpNum) const;
+	uint64_t getArpeggioFMVersion(int arpNum) const;
 	std::unique_ptr<CommandSequence::Iterator> getArpeggioFMIterator(int arpNum) const;
-	std::vector<int> getArpeggioFMUsers(int arpNum) const;
+	InstrumentUserSet getArpeggioFMUsers(int arpNum) const;
 	std::vector<int> getArpeggioFMEntriedIndices() const;
 	int findFirstFreeArpeggioFM() const;
 	int findFirstFreePlainArpeggioFM() const;
@@ -112,13 +130,14 @@ public:
 	void addPitchFMSequenceCommand(int ptNum, int type, int data);
 	void removePitchFMSequenceCommand(int ptNum);
 	void setPitchFMSequenceCommand(int ptNum, int cnt, int type, int data);
-	std::vector<CommandInSequence> getPitchFMSequence(int ptNum);
+	const std::vector<CommandInSequence>& getPitchFMSequence(int ptNum);
 	void setPitchFMLoops(int ptNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times);
-	std::vector<Loop> getPitchFMLoops(int ptNum) const;
+	const std::vector<Loop>& getPitchFMLoops(int ptNum) const;
 	void setPitchFMRelease(int ptNum, ReleaseType type, int begin);
 	Release getPitchFMRelease(int ptNum) const;
+	uint64_t getPitchFMVersion(int ptNum) const;
 	std::unique_ptr<CommandSequence::Iterator> getPitchFMIterator(int ptNum) const;
-	std::vector<int> getPitchFMUsers(int ptNum) const;
+	InstrumentUserSet getPitchFMUsers(int ptNum) const;
 	std::vector<int> getPitchFMEntriedIndices() const;
 	int findFirstFreePitchFM() const;
 	int findFirstFreePlainPitchFM() const;
@@ -126,11 +145,11 @@ public:
 	void setInstrumentFMEnvelopeResetEnabled(int instNum, bool enabled);
 
 private:
-	std::array<std::shared_ptr<EnvelopeFM>, 128> envFM_;
-	std::array<std::shared_ptr<LFOFM>, 128> lfoFM_;
-	std::map<FMEnvelopeParameter, std::array<std::shared_ptr<CommandSequence>, 128>> opSeqFM_;
-	std::array<std::shared_ptr<CommandSequence>, 128> arpFM_;
-	std::array<std::shared_ptr<CommandSequence>, 128> ptFM_;
+	InstrumentPropertyTable<EnvelopeFM> envFM_;
+	InstrumentPropertyTable<LFOFM> lfoFM_;
+	std::map<FMEnvelopeParameter, InstrumentPropertyTable<CommandSequence>> opSeqFM_;
+	InstrumentPropertyTable<CommandSequence> arpFM_;
+	InstrumentPropertyTable<CommandSequence> ptFM_;
 
 	std::vector<FMEnvelopeParameter> envFMParams_;
 
@@ -149,13 +168,14 @@ public:
 	void addWaveFormSSGSequenceCommand(int wfNum, int type, int data);
 	void removeWaveFormSSGSequenceCommand(int wfNum);
 	void setWaveFormSSGSequenceCommand(int wfNum, int cnt, int type, int data);
-	std::vector<CommandInSequence> getWaveFormSSGSequence(int wfNum);
+	const std::vector<CommandInSequence>& getWaveFormSSGSequence(int wfNum);
 	void setWaveFormSSGLoops(int wfNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times);
-	std::vector<Loop> getWaveFormSSGLoops(int wfNum) const;
+	const std::vector<Loop>& getWaveFormSSGLoops(int wfNum) const;
 	void setWaveFormSSGRelease(int wfNum, ReleaseType type, int begin);
 	Release getWaveFormSSGRelease(int wfNum) const;
+	uint64_t getWaveFormSSGVersion(int wfNum) const;
 	std::unique_ptr<CommandSequence::Iterator> getWaveFormSSGIterator(int wfNum) const;
-	std::vector<int> getWaveFormSSGUsers(int wfNum) const;
+	InstrumentUserSet getWaveFormSSGUsers(int wfNum) const;
 	std::vector<int> getWaveFormSSGEntriedIndices() const;
 	int findFirstFreeWaveFormSSG() const;
 	int findFirstFreePlainWaveFormSSG() const;
@@ -167,13 +187,14 @@ public:
 	void addToneNoiseSSGSequenceCommand(int tnNum, int type, int data);
 	void removeToneNoiseSSGSequenceCommand(int tnNum);
 	void setToneNoiseSSGSequenceCommand(int tnNum, int cnt, int type, int data);
-	std::vector<CommandInSequence> getToneNoiseSSGSequence(int tnNum);
+	const std::vector<CommandInSequence>& getToneNoiseSSGSequence(int tnNum);
 	void setToneNoiseSSGLoops(int tnNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times);
-	std::vector<Loop> getToneNoiseSSGLoops(int tnNum) const;
+	const std::vector<Loop>& getToneNoiseSSGLoops(int tnNum) const;
 	void setToneNoiseSSGRelease(int tnNum, ReleaseType type, int begin);
 	Release getToneNoiseSSGRelease(int tnNum) const;
+	uint64_t getToneNoiseSSGVersion(int tnNum) const;
 	std::unique_ptr<CommandSequence::Iterator> getToneNoiseSSGIterator(int tnNum) const;
-	std::vector<int> getToneNoiseSSGUsers(int tnNum) const;
+	InstrumentUserSet getToneNoiseSSGUsers(int tnNum) const;
 	std::vector<int> getToneNoiseSSGEntriedIndices() const;
 	int findFirstFreeToneNoiseSSG() const;
 	int findFirstFreePlainToneNoiseSSG() const;
@@ -185,13 +206,14 @@ public:
 	void addEnvelopeSSGSequenceCommand(int envNum, int type, int data);
 	void removeEnvelopeSSGSequenceCommand(int envNum);
 	void setEnvelopeSSGSequenceCommand(int envNum, int cnt, int type, int data);
-	std::vector<CommandInSequence> getEnvelopeSSGSequence(int envNum);
+	const std::vector<CommandInSequence>& getEnvelopeSSGSequence(int envNum);
 	void setEnvelopeSSGLoops(int envNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times);
-	std::vector<Loop> getEnvelopeSSGLoops(int envNum) const;
+	const std::vector<Loop>& getEnvelopeSSGLoops(int envNum) const;
 	void setEnvelopeSSGRelease(int envNum, ReleaseType type, int begin);
 	Release getEnvelopeSSGRelease(int envNum) const;
+	uint64_t getEnvelopeSSGVersion(int envNum) const;
 	std::unique_ptr<CommandSequence::Iterator> getEnvelopeSSGIterator(int envNum) const;
-	std::vector<int> getEnvelopeSSGUsers(int envNum) const;
+	InstrumentUserSet getEnvelopeSSGUsers(int envNum) const;
 	std::vector<int> getEnvelopeSSGEntriedIndices() const;
 	int findFirstFreeEnvelopeSSG() const;
 	int findFirstFreePlainEnvelopeSSG() const;
@@ -205,13 +227,14 @@ public:
 	void addArpeggioSSGSequenceCommand(int arpNum, int type, int data);
 	void removeArpeggioSSGSequenceCommand(int arpNum);
 	void setArpeggioSSGSequenceCommand(int arpNum, int cnt, int type, int data);
-	std::vector<CommandInSequence> getArpeggioSSGSequence(int arpNum);
+	const std::vector<CommandInSequence>& getArpeggioSSGSequence(int arpNum);
 	void setArpeggioSSGLoops(int arpNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times);
-	std::vector<Loop> getArpeggioSSGLoops(int arpNum) const;
+	const std::vector<Loop>& getArpeggioSSGLoops(int arpNum) const;
 	void setArpeggioSSGRelease(int arpNum, ReleaseType type, int begin);
 	Release getArpeggioSSGRelease(int arpNum) const;
+	uint64_t getArpeggioSSGVersion(int arpNum) const;
 	std::unique_ptr<CommandSequence::Iterator> getArpeggioSSGIterator(int arpNum) const;
-	std::vector<int> getArpeggioSSGUsers(int arpNum) const;
+	InstrumentUserSet getArpeggioSSGUsers(int arpNum) const;
 	std::vector<int> getArpeggioSSGEntriedIndices() const;
 	int findFirstFreeArpeggioSSG() const;
 	int findFirstFreePlainArpeggioSSG() const;
@@ -225,23 +248,24 @@ public:
 	void addPitchSSGSequenceCommand(int ptNum, int type, int data);
 	void removePitchSSGSequenceCommand(int ptNum);
 	void setPitchSSGSequenceCommand(int ptNum, int cnt, int type, int data);
-	std::vector<CommandInSequence> getPitchSSGSequence(int ptNum);
+	const std::vector<CommandInSequence>& getPitchSSGSequence(int ptNum);
 	void setPitchSSGLoops(int ptNum, std::vector<int> begins, std::vector<int> ends, std::vector<int> times);
-	std::vector<Loop> getPitchSSGLoops(int ptNum) const;
+	const std::vector<Loop>& getPitchSSGLoops(int ptNum) const;
 	void setPitchSSGRelease(int ptNum, ReleaseType type, int begin);
 	Release getPitchSSGRelease(int ptNum) const;
+	uint64_t getPitchSSGVersion(int ptNum) const;
 	std::unique_ptr<CommandSequence::Iterator> getPitchSSGIterator(int ptNum) const;
-	std::vector<int> getPitchSSGUsers(int ptNum) const;
+	InstrumentUserSet getPitchSSGUsers(int ptNum) const;
 	std::vector<int> getPitchSSGEntriedIndices() const;
 	int findFirstFreePitchSSG() const;
 	int findFirstFreePlainPitchSSG() const;
 
 private:
-	std::array<std::shared_ptr<CommandSequence>, 128> wfSSG_;
-	std::array<std::shared_ptr<CommandSequence>, 128> envSSG_;
-	std::array<std::shared_ptr<CommandSequence>, 128> tnSSG_;
-	std::array<std::shared_ptr<CommandSequence>, 128> arpSSG_;
-	std::array<std::shared_ptr<CommandSequence>, 128> ptSSG_;
+	InstrumentPropertyTable<CommandSequence> wfSSG_;
+	InstrumentPropertyTable<CommandSequence> envSSG_;
+	InstrumentPropertyTable<CommandSequence> tnSSG_;
+	InstrumentPropertyTable<CommandSequence> arpSSG_;
+	InstrumentPropertyTable<CommandSequence> ptSSG_;
 
 	int cloneSSGWaveForm(int srcNum);
 	int cloneSSGToneNoise(int srcNum);
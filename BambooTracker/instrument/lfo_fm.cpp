@@ -43,6 +43,7 @@ void LFOFM::setParameterValue(FMLFOParameter param, int value)
 	case FMLFOParameter::AM3:	amOp_[2] = value;	break;
 	case FMLFOParameter::AM4:	amOp_[3] = value;	break;
 	}
+	markContentChanged();
 }
 
 int LFOFM::getParameterValue(FMLFOParameter param) const
@@ -71,3 +72,28 @@ bool LFOFM::isEdited() const
 	}
 	return false;
 }
+
+bool LFOFM::hasSameContent(const LFOFM& other) const
+{
+	if (getContentHash() != other.getContentHash()) return false;
+	if (freq_ != other.freq_
+			|| pms_ != other.pms_
+			|| ams_ != other.ams_
+			|| cnt_ != other.cnt_)
+		return false;
+	for (int i = 0; i < 4; ++i) {
+		if (amOp_[i] != other.amOp_[i]) return false;
+	}
+	return true;
+}
+
+size_t LFOFM::calculateContentHash() const
+{
+	size_t h = combineHash(0, freq_);
+	h = combineHash(h, pms_);
+	h = combineHash(h, ams_);
+	h = combineHash(h, cnt_);
+	for (int i = 0; i < 4; ++i)
+		h = combineHash(h, amOp_[i]);
+	return h;
+}
@@ -18,6 +18,10 @@ public:
 	int getParameterValue(FMLFOParameter param) const;
 
 	bool isEdited() const;
+	bool hasSameContent(const LFOFM& other) const;
+
+protected:
+	size_t calculateContentHash() const override;
 
 private:
 	int freq_;
@@ -1,5 +1,8 @@
 #include "bank_io.hpp"
-#include <fstream>
+#include <sys/stat.h>
+#include <utility>
+#include "binary_container.hpp"
+#include "binary_file_writer.hpp"
 #include "file_io.hpp"
 #include "file_io_error.hpp"
 
@@ -7,6 +10,8 @@ BankIO::BankIO()
 {
 }
 
+constexpr size_t BankIO::INDEXED_INST_CNT;
+
 AbstractBank* BankIO::loadBank(std::string path)
 {
 	std::string ext = path.substr(path.find_last_of(".")+1);
@@ -16,29 +21,157 @@ AbstractBank* BankIO::loadBank(std::string path)
 
 AbstractBank* BankIO::loadWOPNFile(std::string path)
 {
-	struct WOPNDeleter {
-		void operator()(WOPNFile *x) { WOPN_Free(x); }
-	};
-
-	std::unique_ptr<WOPNFile, WOPNDeleter> wopn;
+	auto file = std::make_shared<MappedFile>();
+	if (!file->open(path))
+		throw FileInputError(FileIO::FileType::BANK);
 
-	std::ifstream in(path, std::ios::binary);
-	in.seekg(0, std::ios::end);
-	std::streampos size = in.tellg();
+	// Reuse the index if the bank has not been changed since it was created
+	std::string idxPath = path + ".idx";
+	uint64_t fileTime = getModifiedTime(path);
+	uint16_t version;
+	std::vector<WopnBank::InstEntry> entries;
+	if (!loadWOPNIndex(idxPath, *file, fileTime, version, entries)) {
+		struct WOPNDeleter {
+			void operator()(WOPNFile *x) { WOPN_Free(x); }
+		};
 
-	if (!in)
-		throw FileInputError(FileIO::FileType::BANK);
-	else {
-		std::unique_ptr<char[]> buf(new char[size]);
-		in.seekg(0, std::ios::beg);
-		if (!in.read(buf.get(), size) || in.gcount() != size)
-			throw FileInputError(FileIO::FileType::BANK);
-		wopn.reset(WOPN_LoadBankFromMem(buf.get(), size, nullptr));
+		// The parser only reads the mapped memory
+		std::unique_ptr<WOPNFile, WOPNDeleter> wopn(
+					WOPN_LoadBankFromMem(const_cast<char*>(file->data()), file->size(), nullptr));
 		if (!wopn)
 			throw FileCorruptionError(FileIO::FileType::BANK);
+
+		version = wopn->version;
+		entries = indexWOPNFile(*wopn, *file);
+		if (entries.size() >= INDEXED_INST_CNT)
+			saveWOPNIndex(idxPath, *file, fileTime, version, entries);
+	}
+
+	return new WopnBank(file, version, std::move(entries));
+}
+
+std::vector<WopnBank::InstEntry> BankIO::indexWOPNFile(const WOPNFile& wopn, const MappedFile& file)
+{
+	unsigned numM = wopn.banks_count_melodic;
+	unsigned numP = wopn.banks_count_percussion;
+	size_t instSize = WOPN_BankInstSize(wopn.version);
+	// Magic number, version code, header and bank names precede instruments
+	size_t instOfs = (wopn.version >= 2) ? (18 + 34 * (numM + numP)) : 16;
+
+	size_t instMax = 128 * (numP + numM);
+	std::vector<WopnBank::InstEntry> entries;
+	entries.reserve(instMax);
+
+	for (size_t i = 0; i < instMax; ++i, instOfs += instSize) {
+		bool percussive = (i / 128) >= numM;
+		const WOPNBank &bank = percussive ?
+			wopn.banks_percussive[(i / 128) - numM] :
+			wopn.banks_melodic[i / 128];
+		const WOPNInstrument &inst = bank.ins[i % 128];
+		if (inst.inst_flags & WOPN_Ins_IsBlank) continue;
+
+		WopnBank::InstEntry ent;
+		ent.percussive = percussive;
+		ent.msb = bank.bank_midi_msb;
+		ent.lsb = bank.bank_midi_lsb;
+		ent.nth = i % 128;
+		ent.offset = instOfs;
+		ent.name = inst.inst_name;
+
+		// FNV-1a of the parameters following the name
+		ent.hash = 14695981039346656037ull;
+		for (size_t j = 32; j < instSize; ++j) {
+			ent.hash ^= static_cast<uint8_t>(file.data()[instOfs + j]);
+			ent.hash *= 1099511628211ull;
+		}
+
+		entries.push_back(std::move(ent));
 	}
 
-	WopnBank *bank = new WopnBank(wopn.get());
-	wopn.release();
-	return bank;
+	entries.shrink_to_fit();
+	return entries;
+}
+
+bool BankIO::loadWOPNIndex(std::string path, const MappedFile& file, uint64_t fileTime,
+						   uint16_t& version, std::vector<WopnBank::InstEntry>& entries)
+{
+	BinaryContainer ctr;
+	if (!ctr.load(path)) return false;
+
+	try {
+		const BinaryContainer::Span span = ctr.getSpan(0, ctr.size());
+		size_t csr = 0;
+		if (span.readString(csr, 8) != "WOPNIDX ") return false;
+		csr += 8;
+		if (span.readUint32(csr) != file.size()) return false;
+		csr += 4;
+		uint64_t time = span.readUint32(csr);
+		time |= static_cast<uint64_t>(span.readUint32(csr + 4)) << 32;
+		if (time != fileTime) return false;
+		csr += 8;
+		version = span.readUint16(csr);
+		csr += 2;
+		size_t cnt = span.readUint32(csr);
+		csr += 4;
+
+		entries.clear();
+		entries.reserve(cnt);
+		size_t instSize = WOPN_BankInstSize(version);
+		for (size_t i = 0; i < cnt; ++i) {
+			WopnBank::InstEntry ent;
+			ent.percussive = (span.readUint8(csr++) != 0);
+			ent.msb = span.readUint8(csr++);
+			ent.lsb = span.readUint8(csr++);
+			ent.nth = span.readUint8(csr++);
+			ent.offset = span.readUint32(csr);
+			csr += 4;
+			if (ent.offset + instSize > file.size()) return false;
+			ent.hash = span.readUint32(csr);
+			ent.hash |= static_cast<uint64_t>(span.readUint32(csr + 4)) << 32;
+			csr += 8;
+			size_t nameLen = span.readUint8(csr++);
+			ent.name = span.readString(csr, nameLen);
+			csr += nameLen;
+			entries.push_back(std::move(ent));
+		}
+		return true;
+	}
+	catch (std::out_of_range&) {
+		return false;
+	}
+}
+
+void BankIO::saveWOPNIndex(std::string path, const MappedFile& file, uint64_t fileTime,
+						   uint16_t version, const std::vector<WopnBank::InstEntry>& entries)
+{
+	// The index is only a cache, so failure to write it is ignored
+	BinaryFileWriter ctr;
+	if (!ctr.open(path)) return;
+
+	ctr.appendString("WOPNIDX ");
+	ctr.appendUint32(file.size());
+	ctr.appendUint32(static_cast<uint32_t>(fileTime));
+	ctr.appendUint32(static_cast<uint32_t>(fileTime >> 32));
+	ctr.appendUint16(version);
+	ctr.appendUint32(entries.size());
+	for (auto& ent : entries) {
+		ctr.appendUint8(ent.percussive);
+		ctr.appendUint8(ent.msb);
+		ctr.appendUint8(ent.lsb);
+		ctr.appendUint8(ent.nth);
+		ctr.appendUint32(ent.offset);
+		ctr.appendUint32(static_cast<uint32_t>(ent.hash));
+		ctr.appendUint32(static_cast<uint32_t>(ent.hash >> 32));
+		ctr.appendUint8(ent.name.length());
+		ctr.appendString(ent.name);
+	}
+
+	ctr.commit();
+}
+
+uint64_t BankIO::getModifiedTime(std::string path)
+{
+	struct stat st;
+	if (stat(path.c_str(), &st)) return 0;
+	return static_cast<uint64_t>(st.st_mtime);
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "bank.hpp"
+#include "mapped_file.hpp"
 #include "format/wopn_file.h"
 
 class BankIO
@@ -12,4 +14,14 @@ public:
 
 private:
 	BankIO();
+
+	/// Banks which have at least this number of instruments keep the index file next to them
+	static constexpr size_t INDEXED_INST_CNT = 1024;
+
+	static std::vector<WopnBank::InstEntry> indexWOPNFile(const WOPNFile& wopn, const MappedFile& file);
+	static bool loadWOPNIndex(std::string path, const MappedFile& file, uint64_t fileTime,
+							  uint16_t& version, std::vector<WopnBank::InstEntry>& entries);
+	static void saveWOPNIndex(std::string path, const MappedFile& file, uint64_t fileTime,
+							  uint16_t version, const std::vector<WopnBank::InstEntry>& entries);
+	static uint64_t getModifiedTime(std::string path);
 };
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <fstream>
 #include <iterator>
+#include <utility>
 
 BinaryContainer::BinaryContainer(size_t defCapacity)
 	: isLE_(true)
@@ -9,19 +10,26 @@ BinaryContainer::BinaryContainer(size_t defCapacity)
 	if (defCapacity) reserve(defCapacity);
 }
 
+BinaryContainer::BinaryContainer(std::vector<char> buf)
+	: buf_(std::move(buf)), isLE_(true)
+{
+}
+
 size_t BinaryContainer::size() const
 {
-	return buf_.size();
+	return mapped_ ? mapped_->size() : buf_.size();
 }
 
 void BinaryContainer::clear()
 {
+	mapped_.reset();
 	buf_.clear();
 	buf_.shrink_to_fit();
 }
 
 void BinaryContainer::reserve(size_t capacity)
 {
+	detach();
 	buf_.reserve(capacity);
 }
 
@@ -37,6 +45,15 @@ bool BinaryContainer::isLittleEndian() const
 
 bool BinaryContainer::load(std::string path)
 {
+	clear();
+
+	auto file = std::make_shared<MappedFile>();
+	if (file->open(path)) {
+		mapped_ = file;
+		return true;
+	}
+
+	// Fall back to reading into the buffer
 	try {
 		std::ifstream ifs(path, std::ios::binary);
 		buf_.resize(static_cast<size_t>(ifs.seekg(0, std::ios::end).tellg()));
@@ -52,7 +69,7 @@ bool BinaryContainer::save(std::string path)
 {
 	try {
 		std::ofstream ofs(path, std::ios::binary);
-		ofs.write(&buf_[0], static_cast<std::streamsize>(buf_.size()));
+		ofs.write(data(), static_cast<std::streamsize>(size()));
 		return true;
 	}
 	catch (...) {
@@ -62,182 +79,181 @@ bool BinaryContainer::save(std::string path)
 
 void BinaryContainer::appendInt8(const int8_t v)
 {
+	detach();
 	buf_.push_back(static_cast<char>(v));
 }
 
 void BinaryContainer::appendUint8(const uint8_t v)
 {
+	detach();
 	buf_.push_back(static_cast<char>(v));
 }
 
 void BinaryContainer::appendInt16(const int16_t v)
 {
-	append({
-			   static_cast<char>(0x00ff & v),
-			   static_cast<char>(v >> 8),
-		   });
+	append(static_cast<uint32_t>(v), 2);
 }
 
 void BinaryContainer::appendUint16(const uint16_t v)
 {
-	append({
-			   static_cast<char>(0x00ff & v),
-			   static_cast<char>(v >> 8),
-		   });
+	append(static_cast<uint32_t>(v), 2);
 }
 
 void BinaryContainer::appendInt32(const int32_t v)
 {
-	append({
-			   static_cast<char>(0x000000ff & v),
-			   static_cast<char>(0x0000ff & (v >> 8)),
-			   static_cast<char>(0x00ff & (v >> 16)),
-			   static_cast<char>(v >> 24),
-		   });
+	append(static_cast<uint32_t>(v), 4);
 }
 
 void BinaryContainer::appendUint32(const uint32_t v)
 {
-	append({
-			   static_cast<char>(0x000000ff & v),
-			   static_cast<char>(0x0000ff & (v >> 8)),
-			   static_cast<char>(0x00ff & (v >> 16)),
-			   static_cast<char>(v >> 24),
-		   });
+	append(static_cast<uint32_t>(v), 4);
 }
 
 void BinaryContainer::appendChar(const char c)
 {
+	detach();
 	buf_.push_back(c);
 }
 
 void BinaryContainer::appendString(const std::string str)
 {
+	detach();
 	std::copy(str.begin(), str.end(), std::back_inserter(buf_));
 }
 
 void BinaryContainer::writeInt8(size_t offset, const int8_t v)
 {
-	buf_.at(offset) = static_cast<char>(v);
+	detach();
+	checkRange(offset, 1);
+	buf_[offset] = static_cast<char>(v);
 }
 
 void BinaryContainer::writeUint8(size_t offset, const uint8_t v)
 {
-	buf_.at(offset) = static_cast<char>(v);
+	detach();
+	checkRange(offset, 1);
+	buf_[offset] = static_cast<char>(v);
 }
 
 void BinaryContainer::writeInt16(size_t offset, const int16_t v)
 {
-	write(offset, {
-			  static_cast<char>(0x00ff & v),
-			  static_cast<char>(v >> 8),
-		  });
+	write(offset, static_cast<uint32_t>(v), 2);
 }
 
 void BinaryContainer::writeUint16(size_t offset, const uint16_t v)
 {
-	write(offset, {
-			  static_cast<char>(0x00ff & v),
-			  static_cast<char>(v >> 8),
-		  });
+	write(offset, static_cast<uint32_t>(v), 2);
 }
 
 void BinaryContainer::writeInt32(size_t offset, const int32_t v)
 {
-	write(offset, {
-			  static_cast<char>(0x000000ff & v),
-			  static_cast<char>(0x0000ff & (v >> 8)),
-			  static_cast<char>(0x00ff & (v >> 16)),
-			  static_cast<char>(v >> 24),
-		  });
+	write(offset, static_cast<uint32_t>(v), 4);
 }
 
 void BinaryContainer::writeUint32(size_t offset, const uint32_t v)
 {
-	write(offset, {
-			  static_cast<char>(0x000000ff & v),
-			  static_cast<char>(0x0000ff & (v >> 8)),
-			  static_cast<char>(0x00ff & (v >> 16)),
-			  static_cast<char>(v >> 24),
-		  });
+	write(offset, static_cast<uint32_t>(v), 4);
 }
 
 void BinaryContainer::writeChar(size_t offset, const char c)
 {
-	buf_.at(offset) = c;
+	detach();
+	checkRange(offset, 1);
+	buf_[offset] = c;
 }
 
 void BinaryContainer::writeString(size_t offset, const std::string str)
 {
+	detach();
+	checkRange(offset, str.size());
 	std::copy(str.begin(), str.end(), buf_.begin() + offset);
 }
 
 int8_t BinaryContainer::readInt8(size_t offset)
 {
-	return static_cast<int8_t>(buf_.at(offset));
+	checkRange(offset, 1);
+	return static_cast<int8_t>(data()[offset]);
 }
 
 uint8_t BinaryContainer::readUint8(size_t offset)
 {
-	return static_cast<uint8_t>(buf_.at(offset));
+	checkRange(offset, 1);
+	return static_cast<uint8_t>(data()[offset]);
 }
 
 int16_t BinaryContainer::readInt16(size_t offset)
 {
-	std::vector<unsigned char> data = read(offset, 2);
-	return static_cast<int16_t>(data[0] | (data[1] << 8));
+	return static_cast<int16_t>(read(offset, 2));
 }
 
 uint16_t BinaryContainer::readUint16(size_t offset)
 {
-	std::vector<unsigned char> data = read(offset, 2);
-	return static_cast<uint16_t>(data[0] | (data[1] << 8));
+	return static_cast<uint16_t>(read(offset, 2));
 }
 
 int32_t BinaryContainer::readInt32(size_t offset)
 {
-	std::vector<unsigned char> data = read(offset, 4);
-	return static_cast<int32_t>(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+	return static_cast<int32_t>(read(offset, 4));
 }
 
 uint32_t BinaryContainer::readUint32(size_t offset)
 {
-	std::vector<unsigned char> data = read(offset, 4);
-	return static_cast<uint32_t>(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+	return static_cast<uint32_t>(read(offset, 4));
 }
 
 char BinaryContainer::readChar(size_t offset)
 {
-	return buf_.at(offset);
+	checkRange(offset, 1);
+	return data()[offset];
 }
 
 std::string BinaryContainer::readString(size_t offset, size_t length)
 {
-	return std::string(buf_.begin() + offset, buf_.begin() + offset + length);
+	checkRange(offset, length);
+	return std::string(data() + offset, length);
+}
+
+BinaryContainer::Span BinaryContainer::getSpan(size_t offset, size_t size) const
+{
+	checkRange(offset, size);
+	return Span(data(), offset, offset + size, isLE_);
+}
+
+void BinaryContainer::append(uint32_t v, size_t size)
+{
+	detach();
+	size_t offset = buf_.size();
+	buf_.resize(offset + size);
+	store(&buf_[offset], v, size, isLE_);
+}
+
+void BinaryContainer::write(size_t offset, uint32_t v, size_t size)
+{
+	detach();
+	checkRange(offset, size);
+	store(&buf_[offset], v, size, isLE_);
+}
+
+uint32_t BinaryContainer::read(size_t offset, size_t size) const
+{
+	checkRange(offset, size);
+	return load(data() + offset, size, isLE_);
 }
 
-void BinaryContainer::append(std::vector<char> a)
+const char* BinaryContainer::data() const
 {
-	if (isLE_)
-		std::copy(a.begin(), a.end(), std::back_inserter(buf_));
-	else
-		std::reverse_copy(a.begin(), a.end(), std::back_inserter(buf_));
+	return mapped_ ? mapped_->data() : buf_.data();
 }
 
-void BinaryContainer::write(size_t offset, std::vector<char> a)
+void BinaryContainer::detach()
 {
-	if (isLE_)
-		std::copy(a.begin(), a.end(), buf_.begin() + offset);
-	else
-		std::reverse_copy(a.begin(), a.end(), buf_.begin() + offset);
+	if (!mapped_) return;
+	buf_.assign(mapped_->data(), mapped_->data() + mapped_->size());
+	mapped_.reset();
 }
 
-std::vector<unsigned char> BinaryContainer::read(size_t offset, size_t size)
+void BinaryContainer::checkRange(size_t offset, size_t size) const
 {
-	std::vector<unsigned char> data;
-	if (isLE_)
-		std::copy(buf_.begin() + offset, buf_.begin() + offset + size, std::back_inserter(data));
-	else
-		std::reverse_copy(buf_.begin() + offset, buf_.begin() + offset + size, std::back_inserter(data));
-	return data;
+	if (offset > this->size() || this->size() - offset < size)
+		throw std::out_of_range("BinaryContainer: out of range");
 }
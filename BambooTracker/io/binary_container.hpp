@@ -2,12 +2,44 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include <string>
+#include <memory>
+#include <stdexcept>
+#include "mapped_file.hpp"
 
 class BinaryContainer
 {
 public:
+	/// Read-only view of a range in the container.
+	/// Offsets are absolute as in the container, and only the range end is checked on each read.
+	class Span
+	{
+	public:
+		Span(const char* data, size_t begin, size_t end, bool isLittleEndian);
+		size_t begin() const;
+		size_t end() const;
+
+		int8_t readInt8(size_t offset) const;
+		uint8_t readUint8(size_t offset) const;
+		int16_t readInt16(size_t offset) const;
+		uint16_t readUint16(size_t offset) const;
+		int32_t readInt32(size_t offset) const;
+		uint32_t readUint32(size_t offset) const;
+		char readChar(size_t offset) const;
+		std::string readString(size_t offset, size_t length) const;
+		const char* readData(size_t offset, size_t length) const;
+
+	private:
+		const char* data_;
+		size_t begin_, end_;
+		bool isLE_;
+
+		const char* at(size_t offset, size_t size) const;
+	};
+
 	explicit BinaryContainer(size_t defCapacity = 0);
+	explicit BinaryContainer(std::vector<char> buf);
 	size_t size() const;
 	void clear();
 	void reserve(size_t capacity);
@@ -15,6 +47,8 @@ public:
 	void setEndian(bool isLittleEndian);
 	bool isLittleEndian() const;
 
+	/// Map the file and read it in place.
+	/// Its contents are copied to the buffer when the container is modified.
 	bool load(std::string path);
 	bool save(std::string path);
 
@@ -45,11 +79,105 @@ public:
 	char readChar(size_t offset);
 	std::string readString(size_t offset, size_t length);
 
+	/// Throw std::out_of_range if the range exceeds the container
+	Span getSpan(size_t offset, size_t size) const;
+	const char* data() const;
+
 private:
 	std::vector<char> buf_;
+	std::shared_ptr<MappedFile> mapped_;
 	bool isLE_;
 
-	void append(std::vector<char> a);
-	void write(size_t offset, std::vector<char> a);
-	std::vector<unsigned char> read(size_t offset, size_t size);
+	void detach();
+	void checkRange(size_t offset, size_t size) const;
+
+	void append(uint32_t v, size_t size);
+	void write(size_t offset, uint32_t v, size_t size);
+	uint32_t read(size_t offset, size_t size) const;
+
+	static void store(char* dest, uint32_t v, size_t size, bool isLE);
+	static uint32_t load(const char* src, size_t size, bool isLE);
 };
+
+inline BinaryContainer::Span::Span(const char* data, size_t begin, size_t end, bool isLittleEndian)
+	: data_(data), begin_(begin), end_(end), isLE_(isLittleEndian)
+{
+}
+
+inline size_t BinaryContainer::Span::begin() const
+{
+	return begin_;
+}
+
+inline size_t BinaryContainer::Span::end() const
+{
+	return end_;
+}
+
+inline int8_t BinaryContainer::Span::readInt8(size_t offset) const
+{
+	return static_cast<int8_t>(*at(offset, 1));
+}
+
+inline uint8_t BinaryContainer::Span::readUint8(size_t offset) const
+{
+	return static_cast<uint8_t>(*at(offset, 1));
+}
+
+inline int16_t BinaryContainer::Span::readInt16(size_t offset) const
+{
+	return static_cast<int16_t>(load(at(offset, 2), 2, isLE_));
+}
+
+inline uint16_t BinaryContainer::Span::readUint16(size_t offset) const
+{
+	return static_cast<uint16_t>(load(at(offset, 2), 2, isLE_));
+}
+
+inline int32_t BinaryContainer::Span::readInt32(size_t offset) const
+{
+	return static_cast<int32_t>(load(at(offset, 4), 4, isLE_));
+}
+
+inline uint32_t BinaryContainer::Span::readUint32(size_t offset) const
+{
+	return load(at(offset, 4), 4, isLE_);
+}
+
+inline char BinaryContainer::Span::readChar(size_t offset) const
+{
+	return *at(offset, 1);
+}
+
+inline std::string BinaryContainer::Span::readString(size_t offset, size_t length) const
+{
+	return std::string(at(offset, length), length);
+}
+
+inline const char* BinaryContainer::Span::readData(size_t offset, size_t length) const
+{
+	return at(offset, length);
+}
+
+inline const char* BinaryContainer::Span::at(size_t offset, size_t size) const
+{
+	if (offset < begin_ || offset > end_ || end_ - offset < size)
+		throw std::out_of_range("BinaryContainer::Span: out of range");
+	return data_ + offset;
+}
+
+inline void BinaryContainer::store(char* dest, uint32_t v, size_t size, bool isLE)
+{
+	for (size_t i = 0; i < size; ++i) {
+		dest[isLE ? i : (size - 1 - i)] = static_cast<char>(v >> (i << 3));
+	}
+}
+
+inline uint32_t BinaryContainer::load(const char* src, size_t size, bool isLE)
+{
+	uint32_t v = 0;
+	for (size_t i = 0; i < size; ++i) {
+		v |= static_cast<uint32_t>(static_cast<unsigned char>(src[isLE ? i : (size - 1 - i)])) << (i << 3);
+	}
+	return v;
+}
@@ -0,0 +1,231 @@
+#include "binary_file_writer.hpp"
+#include <algorithm>
+#include <cstdlib>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+BinaryFileWriter::BinaryFileWriter(size_t bufSize)
+	: fp_(nullptr),
+	  bufSize_(bufSize ? bufSize : 1),
+	  flushedSize_(0),
+	  hasError_(false)
+{
+	buf_.reserve(bufSize_);
+}
+
+BinaryFileWriter::~BinaryFileWriter()
+{
+	discard();
+}
+
+bool BinaryFileWriter::open(std::string path)
+{
+	discard();
+
+	path_ = path;
+#ifndef _WIN32
+	// Replace the file a symbolic link points to, not the link itself
+	if (char* real = realpath(path.c_str(), nullptr)) {
+		path_ = real;
+		std::free(real);
+	}
+#endif
+	tmpPath_ = path_ + ".tmp";
+	fp_ = std::fopen(tmpPath_.c_str(), "wb");
+	flushedSize_ = 0;
+	hasError_ = !fp_;
+	buf_.clear();
+	return !hasError_;
+}
+
+bool BinaryFileWriter::commit()
+{
+	if (!fp_) return false;
+
+	flush();
+	if (std::fflush(fp_)) hasError_ = true;
+#ifndef _WIN32
+	// Keep the permissions and owner of the file being replaced
+	struct stat st;
+	if (!hasError_ && !stat(path_.c_str(), &st)) {
+		int fd = fileno(fp_);
+		if (fchmod(fd, st.st_mode & 07777)) hasError_ = true;
+		// Changing the owner needs privileges, so a failure is not an error
+		if (fchown(fd, st.st_uid, st.st_gid)) {}
+	}
+#endif
+	// Make sure the data reaches the disk before the file is renamed
+#ifdef _WIN32
+	if (_commit(_fileno(fp_))) hasError_ = true;
+#else
+	if (fsync(fileno(fp_))) hasError_ = true;
+#endif
+	if (std::fclose(fp_)) hasError_ = true;
+	fp_ = nullptr;
+
+	if (!hasError_) {
+#ifdef _WIN32
+		// ReplaceFile keeps the attributes and ACLs of an existing file
+		if (GetFileAttributesA(path_.c_str()) != INVALID_FILE_ATTRIBUTES)
+			hasError_ = !ReplaceFileA(path_.c_str(), tmpPath_.c_str(), nullptr,
+									  REPLACEFILE_IGNORE_MERGE_ERRORS, nullptr, nullptr);
+		else
+			hasError_ = !MoveFileExA(tmpPath_.c_str(), path_.c_str(),
+									 MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+		hasError_ = (std::rename(tmpPath_.c_str(), path_.c_str()) != 0);
+#endif
+	}
+
+	if (hasError_) {
+		std::remove(tmpPath_.c_str());
+		return false;
+	}
+	return true;
+}
+
+void BinaryFileWriter::discard()
+{
+	if (!fp_) return;
+
+	std::fclose(fp_);
+	fp_ = nullptr;
+	std::remove(tmpPath_.c_str());
+}
+
+size_t BinaryFileWriter::size() const
+{
+	return flushedSize_ + buf_.size();
+}
+
+void BinaryFileWriter::appendInt8(const int8_t v)
+{
+	append(static_cast<uint32_t>(v), 1);
+}
+
+void BinaryFileWriter::appendUint8(const uint8_t v)
+{
+	append(static_cast<uint32_t>(v), 1);
+}
+
+void BinaryFileWriter::appendInt16(const int16_t v)
+{
+	append(static_cast<uint32_t>(v), 2);
+}
+
+void BinaryFileWriter::appendUint16(const uint16_t v)
+{
+	append(static_cast<uint32_t>(v), 2);
+}
+
+void BinaryFileWriter::appendInt32(const int32_t v)
+{
+	append(static_cast<uint32_t>(v), 4);
+}
+
+void BinaryFileWriter::appendUint32(const uint32_t v)
+{
+	append(static_cast<uint32_t>(v), 4);
+}
+
+void BinaryFileWriter::appendChar(const char c)
+{
+	append(static_cast<uint32_t>(static_cast<unsigned char>(c)), 1);
+}
+
+void BinaryFileWriter::appendString(const std::string str)
+{
+	appendData(str.data(), str.size());
+}
+
+void BinaryFileWriter::appendData(const char* data, size_t size)
+{
+	for (size_t i = 0; i < size; ) {
+		size_t n = std::min(size - i, bufSize_ - buf_.size());
+		buf_.insert(buf_.end(), data + i, data + i + n);
+		i += n;
+		if (buf_.size() >= bufSize_) flush();
+	}
+}
+
+void BinaryFileWriter::writeInt8(size_t offset, const int8_t v)
+{
+	write(offset, static_cast<uint32_t>(v), 1);
+}
+
+void BinaryFileWriter::writeUint8(size_t offset, const uint8_t v)
+{
+	write(offset, static_cast<uint32_t>(v), 1);
+}
+
+void BinaryFileWriter::writeInt16(size_t offset, const int16_t v)
+{
+	write(offset, static_cast<uint32_t>(v), 2);
+}
+
+void BinaryFileWriter::writeUint16(size_t offset, const uint16_t v)
+{
+	write(offset, static_cast<uint32_t>(v), 2);
+}
+
+void BinaryFileWriter::writeInt32(size_t offset, const int32_t v)
+{
+	write(offset, static_cast<uint32_t>(v), 4);
+}
+
+void BinaryFileWriter::writeUint32(size_t offset, const uint32_t v)
+{
+	write(offset, static_cast<uint32_t>(v), 4);
+}
+
+void BinaryFileWriter::append(uint32_t v, size_t size)
+{
+	for (size_t i = 0; i < size; ++i) {
+		buf_.push_back(static_cast<char>(v >> (i << 3)));
+	}
+	if (buf_.size() >= bufSize_) flush();
+}
+
+void BinaryFileWriter::write(size_t offset, uint32_t v, size_t size)
+{
+	if (offset + size > this->size()) {
+		hasError_ = true;
+		return;
+	}
+
+	char data[4];
+	for (size_t i = 0; i < size; ++i) {
+		data[i] = static_cast<char>(v >> (i << 3));
+	}
+
+	// Patch flushed part in the file
+	size_t i = 0;
+	if (offset < flushedSize_) {
+		size_t n = std::min(size, flushedSize_ - offset);
+		if (!fp_ || std::fseek(fp_, static_cast<long>(offset), SEEK_SET)
+				|| std::fwrite(data, 1, n, fp_) != n
+				|| std::fseek(fp_, 0, SEEK_END))
+			hasError_ = true;
+		i = n;
+	}
+	// Patch buffered part
+	for (; i < size; ++i) {
+		buf_[offset + i - flushedSize_] = data[i];
+	}
+}
+
+void BinaryFileWriter::flush()
+{
+	if (buf_.empty()) return;
+
+	if (!fp_ || std::fwrite(buf_.data(), 1, buf_.size(), fp_) != buf_.size())
+		hasError_ = true;
+	flushedSize_ += buf_.size();
+	buf_.clear();
+}
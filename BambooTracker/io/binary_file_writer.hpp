@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Buffered little-endian writer which streams to a temporary file
+/// and replaces the destination atomically on commit.
+/// Written values can be patched later by offset like BinaryContainer.
+class BinaryFileWriter
+{
+public:
+	explicit BinaryFileWriter(size_t bufSize = 0x10000);
+	~BinaryFileWriter();
+	BinaryFileWriter(const BinaryFileWriter&) = delete;
+	BinaryFileWriter& operator=(const BinaryFileWriter&) = delete;
+
+	bool open(std::string path);
+	/// Flush and rename the temporary file over the destination
+	bool commit();
+	/// Remove the temporary file
+	void discard();
+
+	size_t size() const;
+
+	void appendInt8(const int8_t v);
+	void appendUint8(const uint8_t v);
+	void appendInt16(const int16_t v);
+	void appendUint16(const uint16_t v);
+	void appendInt32(const int32_t v);
+	void appendUint32(const uint32_t v);
+	void appendChar(const char c);
+	void appendString(const std::string str);
+	void appendData(const char* data, size_t size);
+
+	void writeInt8(size_t offset, const int8_t v);
+	void writeUint8(size_t offset, const uint8_t v);
+	void writeInt16(size_t offset, const int16_t v);
+	void writeUint16(size_t offset, const uint16_t v);
+	void writeInt32(size_t offset, const int32_t v);
+	void writeUint32(size_t offset, const uint32_t v);
+
+private:
+	std::FILE* fp_;
+	std::string path_, tmpPath_;
+	std::vector<char> buf_;
+	size_t bufSize_;
+	size_t flushedSize_;
+	bool hasError_;
+
+	void append(uint32_t v, size_t size);
+	void write(size_t offset, uint32_t v, size_t size);
+	void flush();
+};
@@ -174,13 +174,13 @@ void InstrumentIO::saveInstrument(std::string path, std::weak_ptr<InstrumentsMan
 				ctr.appendUint8(0x02 + i);
 				size_t ofs = ctr.size();
 				ctr.appendUint16(0);	// Dummy offset
-				auto seq = instMan.lock()->getOperatorSequenceFMSequence(FileIO::ENV_FM_PARAMS[i], seqNum);
+				const auto& seq = instMan.lock()->getOperatorSequenceFMSequence(FileIO::ENV_FM_PARAMS[i], seqNum);
 				ctr.appendUint16(seq.size());
 				for (auto& com : seq) {
 					ctr.appendUint16(com.type);
 					ctr.appendInt16(com.data);
 				}
-				auto loop = instMan.lock()->getOperatorSequenceFMLoops(FileIO::ENV_FM_PARAMS[i], seqNum);
+				const auto& loop = instMan.lock()->getOperatorSequenceFMLoops(FileIO::ENV_FM_PARAMS[i], seqNum);
 				ctr.appendUint16(loop.size());
 				for (auto& l : loop) {
 					ctr.appendUint16(l.begin);
@@ -218,13 +218,13 @@ void InstrumentIO::saveInstrument(std::string path, std::weak_ptr<InstrumentsMan
 			ctr.appendUint8(0x28);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getArpeggioFMSequence(arpNum);
+			const auto& seq = instMan.lock()->getArpeggioFMSequence(arpNum);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getArpeggioFMLoops(arpNum);
+			const auto& loop = instMan.lock()->getArpeggioFMLoops(arpNum);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -261,13 +261,13 @@ void InstrumentIO::saveInstrument(std::string path, std::weak_ptr<InstrumentsMan
 			ctr.appendUint8(0x29);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getPitchFMSequence(ptNum);
+			const auto& seq = instMan.lock()->getPitchFMSequence(ptNum);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getPitchFMLoops(ptNum);
+			const auto& loop = instMan.lock()->getPitchFMLoops(ptNum);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -309,13 +309,13 @@ void InstrumentIO::saveInstrument(std::string path, std::weak_ptr<InstrumentsMan
 			ctr.appendUint8(0x30);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getWaveFormSSGSequence(wfNum);
+			const auto& seq = instMan.lock()->getWaveFormSSGSequence(wfNum);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getWaveFormSSGLoops(wfNum);
+			const auto& loop = instMan.lock()->getWaveFormSSGLoops(wfNum);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -352,13 +352,13 @@ void InstrumentIO::saveInstrument(std::string path, std::weak_ptr<InstrumentsMan
 			ctr.appendUint8(0x31);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getToneNoiseSSGSequence(tnNum);
+			const auto& seq = instMan.lock()->getToneNoiseSSGSequence(tnNum);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getToneNoiseSSGLoops(tnNum);
+			const auto& loop = instMan.lock()->getToneNoiseSSGLoops(tnNum);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -395,13 +395,13 @@ void InstrumentIO::saveInstrument(std::string path, std::weak_ptr<InstrumentsMan
 			ctr.appendUint8(0x32);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getEnvelopeSSGSequence(envNum);
+			const auto& seq = instMan.lock()->getEnvelopeSSGSequence(envNum);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getEnvelopeSSGLoops(envNum);
+			const auto& loop = instMan.lock()->getEnvelopeSSGLoops(envNum);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -438,13 +438,13 @@ void InstrumentIO::saveInstrument(std::string path, std::weak_ptr<InstrumentsMan
 			ctr.appendUint8(0x33);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getArpeggioSSGSequence(arpNum);
+			const auto& seq = instMan.lock()->getArpeggioSSGSequence(arpNum);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getArpeggioSSGLoops(arpNum);
+			const auto& loop = instMan.lock()->getArpeggioSSGLoops(arpNum);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -481,13 +481,13 @@ void InstrumentIO::saveInstrument(std::string path, std::weak_ptr<InstrumentsMan
 			ctr.appendUint8(0x34);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getPitchSSGSequence(ptNum);
+			const auto& seq = instMan.lock()->getPitchSSGSequence(ptNum);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getPitchSSGLoops(ptNum);
+			const auto& loop = instMan.lock()->getPitchSSGLoops(ptNum);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
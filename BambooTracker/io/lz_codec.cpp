@@ -0,0 +1,122 @@
+#include "lz_codec.hpp"
+#include <cstdint>
+#include <cstring>
+
+LZCodec::LZCodec()
+{
+}
+
+std::vector<char> LZCodec::compress(const char* src, size_t size)
+{
+	std::vector<char> dest;
+	dest.reserve(size / 2 + 16);
+
+	std::vector<size_t> table(static_cast<size_t>(1) << HASH_BITS, SIZE_MAX);
+	size_t anchor = 0;	// Start of pending literals
+	size_t pos = 0;
+	while (size >= MIN_MATCH && pos <= size - MIN_MATCH) {
+		uint32_t v = read32(src + pos);
+		size_t& entry = table[hash(v)];
+		size_t cand = entry;
+		entry = pos;
+		if (cand == SIZE_MAX || pos - cand > MAX_DISTANCE || read32(src + cand) != v) {
+			++pos;
+			continue;
+		}
+
+		size_t len = MIN_MATCH;
+		while (pos + len < size && src[cand + len] == src[pos + len]) ++len;
+
+		// Sequence: token, literals, distance, match length
+		size_t litLen = pos - anchor;
+		size_t matchLen = len - MIN_MATCH;
+		dest.push_back(static_cast<char>(((litLen < 15 ? litLen : 15) << 4)
+										 | (matchLen < 15 ? matchLen : 15)));
+		if (litLen >= 15) appendLength(dest, litLen - 15);
+		dest.insert(dest.end(), src + anchor, src + pos);
+		size_t dist = pos - cand;
+		dest.push_back(static_cast<char>(dist));
+		dest.push_back(static_cast<char>(dist >> 8));
+		if (matchLen >= 15) appendLength(dest, matchLen - 15);
+
+		pos += len;
+		anchor = pos;
+	}
+
+	// Last sequence has only literals
+	size_t litLen = size - anchor;
+	dest.push_back(static_cast<char>((litLen < 15 ? litLen : 15) << 4));
+	if (litLen >= 15) appendLength(dest, litLen - 15);
+	dest.insert(dest.end(), src + anchor, src + size);
+
+	return dest;
+}
+
+bool LZCodec::decompress(const char* src, size_t size, std::vector<char>& dest, size_t rawSize)
+{
+	// Reject a broken size before allocating for it
+	if (rawSize / MAX_RATIO > size) return false;
+
+	dest.resize(rawSize);
+	char* out = dest.data();
+	size_t ip = 0, op = 0;
+
+	auto readLength = [&](size_t& len) {
+		uint8_t b;
+		do {
+			if (ip >= size) return false;
+			b = static_cast<uint8_t>(src[ip++]);
+			len += b;
+		} while (b == 255);
+		return true;
+	};
+
+	while (ip < size) {
+		uint8_t token = static_cast<uint8_t>(src[ip++]);
+
+		size_t litLen = token >> 4;
+		if (litLen == 15 && !readLength(litLen)) return false;
+		if (litLen > size - ip || litLen > rawSize - op) return false;
+		if (litLen) std::memcpy(out + op, src + ip, litLen);
+		ip += litLen;
+		op += litLen;
+		if (ip == size) break;	// End of the last sequence
+
+		if (size - ip < 2) return false;
+		size_t dist = static_cast<uint8_t>(src[ip]) | (static_cast<uint8_t>(src[ip + 1]) << 8);
+		ip += 2;
+		size_t len = token & 0x0f;
+		if (len == 15 && !readLength(len)) return false;
+		len += MIN_MATCH;
+		if (!dist || dist > op || len > rawSize - op) return false;
+		const char* m = out + op - dist;
+		if (dist >= len) {
+			std::memcpy(out + op, m, len);
+		}
+		else {
+			// Copy bytewise since the match overlaps the output
+			for (size_t i = 0; i < len; ++i) out[op + i] = m[i];
+		}
+		op += len;
+	}
+
+	return op == rawSize;
+}
+
+void LZCodec::appendLength(std::vector<char>& dest, size_t len)
+{
+	for (; len >= 255; len -= 255) dest.push_back(static_cast<char>(255));
+	dest.push_back(static_cast<char>(len));
+}
+
+uint32_t LZCodec::read32(const char* p)
+{
+	uint32_t v;
+	std::memcpy(&v, p, 4);
+	return v;
+}
+
+size_t LZCodec::hash(uint32_t v)
+{
+	return (v * 2654435761u) >> (32 - HASH_BITS);
+}
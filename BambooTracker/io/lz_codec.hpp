@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Byte-oriented LZ77 codec in the layout of LZ4 blocks.
+/// It favors speed over ratio so that the saved bytes outweigh the coding time.
+class LZCodec
+{
+public:
+	static std::vector<char> compress(const char* src, size_t size);
+	/// Return false if the data is corrupted or does not expand to rawSize bytes
+	static bool decompress(const char* src, size_t size, std::vector<char>& dest, size_t rawSize);
+
+private:
+	LZCodec();
+
+	static constexpr size_t MIN_MATCH = 4;
+	static constexpr size_t MAX_DISTANCE = 0xffff;
+	/// A length byte of 255 adds at most 255 bytes, so no data expands further
+	static constexpr size_t MAX_RATIO = 255;
+	static constexpr int HASH_BITS = 14;
+
+	static void appendLength(std::vector<char>& dest, size_t len);
+	static uint32_t read32(const char* p);
+	static size_t hash(uint32_t v);
+};
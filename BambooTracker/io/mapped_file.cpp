@@ -0,0 +1,116 @@
+#include "mapped_file.hpp"
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+	: data_(nullptr),
+	  size_(0),
+	  isOpen_(false)
+#ifdef _WIN32
+	  , file_(INVALID_HANDLE_VALUE),
+	  mapping_(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(std::string path)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return false;
+	}
+	file_ = file;
+	size_ = static_cast<size_t>(size.QuadPart);
+
+	// Empty file cannot be mapped
+	if (size_) {
+		mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping_) {
+			close();
+			return false;
+		}
+		data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+		if (!data_) {
+			close();
+			return false;
+		}
+	}
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1) {
+		::close(fd);
+		return false;
+	}
+	size_ = static_cast<size_t>(st.st_size);
+
+	// Empty file cannot be mapped
+	if (size_) {
+		void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) {
+			::close(fd);
+			size_ = 0;
+			return false;
+		}
+		data_ = static_cast<const char*>(p);
+	}
+	// The mapping is kept after closing the descriptor
+	::close(fd);
+#endif
+
+	isOpen_ = true;
+	return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (data_) UnmapViewOfFile(data_);
+	if (mapping_) CloseHandle(mapping_);
+	if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+	mapping_ = nullptr;
+	file_ = INVALID_HANDLE_VALUE;
+#else
+	if (data_) munmap(const_cast<char*>(data_), size_);
+#endif
+	data_ = nullptr;
+	size_ = 0;
+	isOpen_ = false;
+}
+
+bool MappedFile::isOpen() const
+{
+	return isOpen_;
+}
+
+const char* MappedFile::data() const
+{
+	return data_;
+}
+
+size_t MappedFile::size() const
+{
+	return size_;
+}
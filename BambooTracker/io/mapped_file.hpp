@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(std::string path);
+	void close();
+	bool isOpen() const;
+
+	const char* data() const;
+	size_t size() const;
+
+private:
+	const char* data_;
+	size_t size_;
+	bool isOpen_;
+#ifdef _WIN32
+	void* file_;
+	void* mapping_;
+#endif
+};
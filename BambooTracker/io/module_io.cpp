@@ -1,5 +1,20 @@
 #include "module_io.hpp"
+#include <cstdio>
 #include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <unordered_set>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+#include "binary_file_writer.hpp"
+#include "lz_codec.hpp"
 #include "version.hpp"
 #include "file_io_error.hpp"
 #include "file_io.hpp"
@@ -9,16 +24,46 @@ ModuleIO::ModuleIO()
 }
 
 void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
-						  std::weak_ptr<InstrumentsManager> instMan)
+						  std::weak_ptr<InstrumentsManager> instMan, bool isCompressed)
 {
-	BinaryContainer ctr;
+	BinaryFileWriter ctr;
+	if (!ctr.open(path)) throw FileOutputError(FileIO::FileType::MOD);
 
 	ctr.appendString("BambooTrackerMod");
 	size_t eofOfs = ctr.size();
 	ctr.appendUint32(0);	// Dummy EOF offset
-	uint32_t fileVersion = Version::ofModuleFileInBCD();
+	// Uncompressed modules keep the version before the packed section
+	// so that older versions can still load them
+	uint32_t fileVersion = isCompressed ? Version::ofModuleFileInBCD() : Version::ofUncompressedModuleFileInBCD();
 	ctr.appendUint32(fileVersion);
 
+	if (isCompressed) {
+		BinaryContainer sec;
+		saveSections(sec, mod, instMan);
+		std::vector<char> packed = LZCodec::compress(sec.data(), sec.size());
+
+		/***** Packed section *****/
+		ctr.appendString("PACKED  ");
+		ctr.appendUint32(8 + packed.size());
+		ctr.appendUint32(sec.size());
+		ctr.appendData(packed.data(), packed.size());
+	}
+	else {
+		saveSections(ctr, mod, instMan);
+	}
+
+	ctr.writeUint32(eofOfs, ctr.size() - eofOfs);
+
+	mod.lock()->setFilePath(path);
+
+	if (!ctr.commit()) throw FileOutputError(FileIO::FileType::MOD);
+}
+
+template <class Container>
+void ModuleIO::saveSections(Container& ctr, std::weak_ptr<Module> mod,
+							std::weak_ptr<InstrumentsManager> instMan)
+{
+	uint32_t fileVersion = Version::ofModuleFileInBCD();
 
 	/***** Module section *****/
 	ctr.appendString("MODULE  ");
@@ -228,13 +273,13 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 				ctr.appendUint8(idx);
 				size_t ofs = ctr.size();
 				ctr.appendUint16(0);	// Dummy offset
-				auto seq = instMan.lock()->getOperatorSequenceFMSequence(FileIO::ENV_FM_PARAMS[i], idx);
+				const auto& seq = instMan.lock()->getOperatorSequenceFMSequence(FileIO::ENV_FM_PARAMS[i], idx);
 				ctr.appendUint16(seq.size());
 				for (auto& com : seq) {
 					ctr.appendUint16(com.type);
 					ctr.appendInt16(com.data);
 				}
-				auto loop = instMan.lock()->getOperatorSequenceFMLoops(FileIO::ENV_FM_PARAMS[i], idx);
+				const auto& loop = instMan.lock()->getOperatorSequenceFMLoops(FileIO::ENV_FM_PARAMS[i], idx);
 				ctr.appendUint16(loop.size());
 				for (auto& l : loop) {
 					ctr.appendUint16(l.begin);
@@ -276,13 +321,13 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 			ctr.appendUint8(idx);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getArpeggioFMSequence(idx);
+			const auto& seq = instMan.lock()->getArpeggioFMSequence(idx);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getArpeggioFMLoops(idx);
+			const auto& loop = instMan.lock()->getArpeggioFMLoops(idx);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -323,13 +368,13 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 			ctr.appendUint8(idx);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getPitchFMSequence(idx);
+			const auto& seq = instMan.lock()->getPitchFMSequence(idx);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getPitchFMLoops(idx);
+			const auto& loop = instMan.lock()->getPitchFMLoops(idx);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -370,13 +415,13 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 			ctr.appendUint8(idx);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getWaveFormSSGSequence(idx);
+			const auto& seq = instMan.lock()->getWaveFormSSGSequence(idx);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getWaveFormSSGLoops(idx);
+			const auto& loop = instMan.lock()->getWaveFormSSGLoops(idx);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -417,13 +462,13 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 			ctr.appendUint8(idx);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getToneNoiseSSGSequence(idx);
+			const auto& seq = instMan.lock()->getToneNoiseSSGSequence(idx);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getToneNoiseSSGLoops(idx);
+			const auto& loop = instMan.lock()->getToneNoiseSSGLoops(idx);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -464,13 +509,13 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 			ctr.appendUint8(idx);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getEnvelopeSSGSequence(idx);
+			const auto& seq = instMan.lock()->getEnvelopeSSGSequence(idx);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getEnvelopeSSGLoops(idx);
+			const auto& loop = instMan.lock()->getEnvelopeSSGLoops(idx);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -512,13 +557,13 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 			ctr.appendUint8(idx);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getArpeggioSSGSequence(idx);
+			const auto& seq = instMan.lock()->getArpeggioSSGSequence(idx);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getArpeggioSSGLoops(idx);
+			const auto& loop = instMan.lock()->getArpeggioSSGLoops(idx);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -559,13 +604,13 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 			ctr.appendUint8(idx);
 			size_t ofs = ctr.size();
 			ctr.appendUint16(0);	// Dummy offset
-			auto seq = instMan.lock()->getPitchSSGSequence(idx);
+			const auto& seq = instMan.lock()->getPitchSSGSequence(idx);
 			ctr.appendUint16(seq.size());
 			for (auto& com : seq) {
 				ctr.appendUint16(com.type);
 				ctr.appendInt16(com.data);
 			}
-			auto loop = instMan.lock()->getPitchSSGLoops(idx);
+			const auto& loop = instMan.lock()->getPitchSSGLoops(idx);
 			ctr.appendUint16(loop.size());
 			for (auto& l : loop) {
 				ctr.appendUint16(l.begin);
@@ -662,7 +707,7 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 				ctr.appendUint8(idx);
 				size_t ptnOfs = ctr.size();
 				ctr.appendUint32(0);	// Dummy pattern subblock offset
-				auto& pattern = track.getPattern(idx);
+				const Pattern& pattern = track.getPattern(idx);
 
 				// Step
 				std::vector<int> stepIdcs = pattern.getEditedStepIndices();
@@ -711,16 +756,11 @@ void ModuleIO::saveModule(std::string path, std::weak_ptr<Module> mod,
 
 	}
 	ctr.writeUint32(songSecOfs, ctr.size() - songSecOfs);
-
-	ctr.writeUint32(eofOfs, ctr.size() - eofOfs);
-
-	mod.lock()->setFilePath(path);
-
-	if (!ctr.save(path)) throw FileOutputError(FileIO::FileType::MOD);
 }
 
-void ModuleIO::loadModule(std::string path, std::weak_ptr<Module> mod,
-						  std::weak_ptr<InstrumentsManager> instMan)
+bool ModuleIO::loadModule(std::string path, std::weak_ptr<Module> mod,
+						  std::weak_ptr<InstrumentsManager> instMan,
+						  std::function<bool(size_t, size_t)> f)
 {
 	BinaryContainer ctr;
 
@@ -738,22 +778,57 @@ void ModuleIO::loadModule(std::string path, std::weak_ptr<Module> mod,
 		throw FileVersionError(fileVersion, Version::ofApplicationInBCD(), FileIO::FileType::MOD);
 	globCsr += 4;
 
+	if (!loadSections(ctr, globCsr, eof, mod, instMan, fileVersion, f)) return false;
+
+	mod.lock()->setFilePath(path);
+	return true;
+}
+
+bool ModuleIO::loadSections(BinaryContainer& ctr, size_t globCsr, size_t eof,
+							std::weak_ptr<Module> mod, std::weak_ptr<InstrumentsManager> instMan,
+							uint32_t version, std::function<bool(size_t, size_t)> f)
+{
+	auto poll = [&](size_t csr) { return f && f((csr < eof) ? csr : eof, eof); };
+
 	while (globCsr < eof) {
 		if (ctr.readString(globCsr, 8) == "MODULE  ")
-			globCsr = loadModuleSectionInModule(mod, ctr, globCsr + 8, fileVersion);
+			globCsr = loadModuleSectionInModule(mod, ctr, globCsr + 8, version);
 		else if (ctr.readString(globCsr, 8) == "INSTRMNT")
-			globCsr = loadInstrumentSectionInModule(instMan, ctr, globCsr + 8, fileVersion);
+			globCsr = loadInstrumentSectionInModule(instMan, ctr, globCsr + 8, version);
 		else if (ctr.readString(globCsr, 8) == "INSTPROP")
-			globCsr = loadInstrumentPropertySectionInModule(instMan, ctr, globCsr + 8, fileVersion);
+			globCsr = loadInstrumentPropertySectionInModule(instMan, ctr, globCsr + 8, version);
 		else if (ctr.readString(globCsr, 8) == "GROOVE  ")
-			globCsr = loadGrooveSectionInModule(mod, ctr, globCsr + 8, fileVersion);
-		else if (ctr.readString(globCsr, 8) == "SONG    ")
-			globCsr = loadSongSectionInModule(mod, ctr, globCsr + 8, fileVersion);
+			globCsr = loadGrooveSectionInModule(mod, ctr, globCsr + 8, version);
+		else if (ctr.readString(globCsr, 8) == "SONG    ") {
+			globCsr = loadSongSectionInModule(mod, ctr, globCsr + 8, version, poll);
+			if (!globCsr) return false;
+		}
+		else if (ctr.readString(globCsr, 8) == "PACKED  ") {
+			// Sections are compressed together, and their offsets are relative to the unpacked data
+			size_t packOfs = ctr.readUint32(globCsr + 8);
+			size_t rawSize = ctr.readUint32(globCsr + 12);
+			if (packOfs < 8) throw FileCorruptionError(FileIO::FileType::MOD);
+			const BinaryContainer::Span span = ctr.getSpan(globCsr + 16, packOfs - 8);
+			std::vector<char> buf;
+			if (!LZCodec::decompress(span.readData(span.begin(), packOfs - 8), packOfs - 8, buf, rawSize))
+				throw FileCorruptionError(FileIO::FileType::MOD);
+			BinaryContainer unpacked(std::move(buf));
+			// Map progress in the unpacked data to the range of the packed section
+			size_t packBegin = globCsr;
+			size_t packSize = 8 + packOfs;
+			auto packedPoll = [&](size_t loaded, size_t whole) {
+				return poll(packBegin + static_cast<size_t>(static_cast<double>(packSize) * loaded / whole));
+			};
+			if (!loadSections(unpacked, 0, rawSize, mod, instMan, version, packedPoll)) return false;
+			globCsr += packSize;
+		}
 		else
 			throw FileCorruptionError(FileIO::FileType::MOD);
+
+		if (poll(globCsr)) return false;
 	}
 
-	mod.lock()->setFilePath(path);
+	return true;
 }
 
 size_t ModuleIO::loadModuleSectionInModule(std::weak_ptr<Module> mod, BinaryContainer& ctr,
@@ -1839,32 +1914,43 @@ size_t ModuleIO::loadGrooveSectionInModule(std::weak_ptr<Module> mod, BinaryCont
 	return globCsr + grvOfs;
 }
 
-size_t ModuleIO::loadSongSectionInModule(std::weak_ptr<Module> mod, BinaryContainer& ctr, size_t globCsr, uint32_t version)
+size_t ModuleIO::loadSongSectionInModule(std::weak_ptr<Module> mod, BinaryContainer& ctr, size_t globCsr, uint32_t version,
+										 std::function<bool(size_t)> f)
 {
 	size_t songOfs = ctr.readUint32(globCsr);
+	const BinaryContainer::Span span = ctr.getSpan(globCsr, songOfs);
+
+	// Index songs and create them before taking references to their tracks
+	struct SongIndex
+	{
+		uint8_t idx;
+		size_t begin, end;
+	};
+	std::vector<SongIndex> songIdcs;
 	size_t songCsr = globCsr + 4;
-	uint8_t cnt = ctr.readUint8(songCsr++);
+	uint8_t cnt = span.readUint8(songCsr++);
+	songIdcs.reserve(cnt);
 	for (uint8_t i = 0; i < cnt; ++i) {
-		uint8_t idx = ctr.readUint8(songCsr++);
-		size_t sOfs = ctr.readUint32(songCsr);
+		uint8_t idx = span.readUint8(songCsr++);
+		size_t sOfs = span.readUint32(songCsr);
 		size_t scsr = songCsr + 4;
 		songCsr += sOfs;
-		size_t titleLen = ctr.readUint32(scsr);
+		size_t titleLen = span.readUint32(scsr);
 		scsr += 4;
 		std::string title = u8"";
-		if (titleLen > 0) title = ctr.readString(scsr, titleLen);
+		if (titleLen > 0) title = span.readString(scsr, titleLen);
 		scsr += titleLen;
-		uint32_t tempo = ctr.readUint32(scsr);
+		uint32_t tempo = span.readUint32(scsr);
 		scsr += 4;
-		uint8_t groove = ctr.readUint8(scsr);
+		uint8_t groove = span.readUint8(scsr);
 		scsr += 1;
 		bool isTempo = (groove & 0x80) ? true : false;
 		groove &= 0x7f;
-		uint32_t speed = ctr.readUint32(scsr);
+		uint32_t speed = span.readUint32(scsr);
 		scsr += 4;
-		size_t ptnSize = ctr.readUint8(scsr) + 1;
+		size_t ptnSize = span.readUint8(scsr) + 1;
 		scsr += 1;
-		switch (ctr.readUint8(scsr++)) {
+		switch (span.readUint8(scsr++)) {
 		case 0x00:	// Standard
 		{
 			mod.lock()->addSong(idx, SongType::STD, title, isTempo, tempo, groove, speed, ptnSize);
@@ -1873,90 +1959,166 @@ size_t ModuleIO::loadSongSectionInModule(std::weak_ptr<Module> mod, BinaryContai
 		default:
 			throw FileCorruptionError(FileIO::FileType::MOD);
 		}
-		auto& song = mod.lock()->getSong(idx);
-		while (scsr < songCsr) {
+		songIdcs.push_back({ idx, scsr, songCsr });
+	}
+
+	// Patterns are independent, so decode them in parallel
+	std::vector<PatternIndex> ptnIdcs;
+	std::atomic_size_t next(0);
+	std::atomic_bool isCanceled(false);
+	// Only the calling thread reports progress
+	auto decode = [&](bool isPolling) {
+		for (size_t i = next++; i < ptnIdcs.size() && !isCanceled; i = next++) {
+			loadPatternInModule(ptnIdcs[i], span, version);
+			if (isPolling && f(ptnIdcs[i].end)) isCanceled = true;
+		}
+	};
+
+	// Index and decode song by song so that progress advances with decoded patterns.
+	// Each pattern must appear once because patterns are decoded in parallel
+	std::unordered_set<const Pattern*> indexedPtns;
+	for (auto& si : songIdcs) {
+		auto& song = mod.lock()->getSong(si.idx);
+		ptnIdcs.clear();
+		size_t scsr = si.begin;
+		while (scsr < si.end) {
 			// Song
-			uint8_t trackIdx = ctr.readUint8(scsr++);
+			uint8_t trackIdx = span.readUint8(scsr++);
 			auto& track = song.getTrack(trackIdx);
-			size_t trackOfs = ctr.readUint32(scsr);
+			size_t trackOfs = span.readUint32(scsr);
 			size_t trackEnd = scsr + trackOfs;
 			size_t tcsr = scsr + 4;
-			uint8_t odrLen = ctr.readUint8(tcsr++) + 1;
-			for (uint8_t oi = 0; oi < odrLen; ++oi) {
-				if (!oi)
-					track.registerPatternToOrder(oi, ctr.readUint8(tcsr++));
-				else {
-					track.insertOrderBelow(oi - 1);
-					track.registerPatternToOrder(oi, ctr.readUint8(tcsr++));
-				}
+			size_t odrLen = span.readUint8(tcsr++) + 1;
+			std::vector<int> orders(odrLen);
+			for (size_t oi = 0; oi < odrLen; ++oi) {
+				orders[oi] = span.readUint8(tcsr++);
 			}
+			track.setOrders(orders);
 
 			// Pattern
 			while (tcsr < trackEnd) {
-				uint8_t ptnIdx = ctr.readUint8(tcsr++);
+				uint8_t ptnIdx = span.readUint8(tcsr++);
 				auto& pattern = track.getPattern(ptnIdx);
-				size_t ptnOfs = ctr.readUint32(tcsr);
+				if (!indexedPtns.insert(&pattern).second)
+					throw FileCorruptionError(FileIO::FileType::MOD);
+				size_t ptnOfs = span.readUint32(tcsr);
 				size_t pcsr = tcsr + 4;
 				tcsr += ptnOfs;
-
-				// Step
-				while (pcsr < tcsr) {
-					uint32_t stepIdx = ctr.readUint8(pcsr++);
-					auto& step = pattern.getStep(stepIdx);
-					uint16_t eventFlag = ctr.readUint16(pcsr);
-					pcsr += 2;
-					if (eventFlag & 0x0001)	{
-						if (version >= Version::toBCD(1, 0, 2)) {
-							step.setNoteNumber(ctr.readInt8(pcsr++));
-						}
-						else {
-							// Change FM octave (song type is only 0x00 before v1.0.2)
-							int8_t nn = ctr.readInt8(pcsr++);
-							if (trackIdx < 6 && 0 <= nn && nn < 84)
-								step.setNoteNumber(nn + 12);
-							else
-								step.setNoteNumber(nn);
-						}
-					}
-					if (eventFlag & 0x0002)	step.setInstrumentNumber(ctr.readUint8(pcsr++));
-					if (eventFlag & 0x0004)	step.setVolume(ctr.readUint8(pcsr++));
-					if (eventFlag & 0x0008)	{
-						step.setEffectID(0, ctr.readString(pcsr, 2));
-						pcsr += 2;
-					}
-					if (eventFlag & 0x0010)	step.setEffectValue(0, ctr.readUint8(pcsr++));
-					if (eventFlag & 0x0020)	{
-						step.setEffectID(1, ctr.readString(pcsr, 2));
-						pcsr += 2;
-					}
-					if (eventFlag & 0x0040)	step.setEffectValue(1, ctr.readUint8(pcsr++));
-					if (eventFlag & 0x0080)	{
-						step.setEffectID(2, ctr.readString(pcsr, 2));
-						pcsr += 2;
-					}
-					if (eventFlag & 0x0100)	step.setEffectValue(2, ctr.readUint8(pcsr++));
-					if (eventFlag & 0x0200)	{
-						step.setEffectID(3, ctr.readString(pcsr, 2));
-						pcsr += 2;
-					}
-					if (eventFlag & 0x0400)	step.setEffectValue(3, ctr.readUint8(pcsr++));
-				}
+				ptnIdcs.push_back({ &pattern, trackIdx, pcsr, tcsr });
 			}
 
 			scsr += trackOfs;
 		}
+
+		size_t threadCnt = std::max(1u, std::thread::hardware_concurrency());
+		if (threadCnt > ptnIdcs.size()) threadCnt = ptnIdcs.size();
+		next = 0;
+		std::vector<std::future<void>> workers;
+		for (size_t i = 1; i < threadCnt; ++i) {
+			workers.push_back(std::async(std::launch::async, decode, false));
+		}
+		std::exception_ptr error;
+		try {
+			decode(true);
+		} catch (...) {
+			error = std::current_exception();
+		}
+		// Wait for all workers before rethrowing because they refer to local data
+		for (auto& w : workers) {
+			try {
+				w.get();
+			} catch (...) {
+				if (!error) error = std::current_exception();
+			}
+		}
+		if (error) std::rethrow_exception(error);
+		if (isCanceled || f(si.end)) return 0;
 	}
 
 	return globCsr + songOfs;
 }
 
+void ModuleIO::loadPatternInModule(const PatternIndex& idx, const BinaryContainer::Span& span,
+								   uint32_t version)
+{
+	// Step
+	size_t pcsr = idx.begin;
+	while (pcsr < idx.end) {
+		uint32_t stepIdx = span.readUint8(pcsr++);
+		auto& step = idx.pattern->getStep(stepIdx);
+		uint16_t eventFlag = span.readUint16(pcsr);
+		pcsr += 2;
+		if (eventFlag & 0x0001)	{
+			if (version >= Version::ofUncompressedModuleFileInBCD()) {
+				step.setNoteNumber(span.readInt8(pcsr++));
+			}
+			else {
+				// Change FM octave (song type is only 0x00 before v1.0.2)
+				int8_t nn = span.readInt8(pcsr++);
+				if (idx.trackIdx < 6 && 0 <= nn && nn < 84)
+					step.setNoteNumber(nn + 12);
+				else
+					step.setNoteNumber(nn);
+			}
+		}
+		if (eventFlag & 0x0002)	idx.pattern->setStepInstrumentNumber(stepIdx, span.readUint8(pcsr++));
+		if (eventFlag & 0x0004)	step.setVolume(span.readUint8(pcsr++));
+		if (eventFlag & 0x0008)	{
+			step.setEffectID(0, span.readString(pcsr, 2));
+			pcsr += 2;
+		}
+		if (eventFlag & 0x0010)	step.setEffectValue(0, span.readUint8(pcsr++));
+		if (eventFlag & 0x0020)	{
+			step.setEffectID(1, span.readString(pcsr, 2));
+			pcsr += 2;
+		}
+		if (eventFlag & 0x0040)	step.setEffectValue(1, span.readUint8(pcsr++));
+		if (eventFlag & 0x0080)	{
+			step.setEffectID(2, span.readString(pcsr, 2));
+			pcsr += 2;
+		}
+		if (eventFlag & 0x0100)	step.setEffectValue(2, span.readUint8(pcsr++));
+		if (eventFlag & 0x0200)	{
+			step.setEffectID(3, span.readString(pcsr, 2));
+			pcsr += 2;
+		}
+		if (eventFlag & 0x0400)	step.setEffectValue(3, span.readUint8(pcsr++));
+	}
+}
+
 void ModuleIO::backupModule(std::string path)
 {
-	try {
+	// Saving replaces the module file by renaming,
+	// so a hard link keeps the previous contents without copying.
+	// The new backup is made under a temporary name and renamed over the old one,
+	// so the old backup survives a failure
+	std::string bak = path + ".bak";
+	std::string tmp = bak + ".tmp";
+	std::remove(tmp.c_str());
+#ifdef _WIN32
+	bool isCreated = CreateHardLinkA(tmp.c_str(), path.c_str(), nullptr);
+#else
+	bool isCreated = !linkat(AT_FDCWD, path.c_str(), AT_FDCWD, tmp.c_str(), AT_SYMLINK_FOLLOW);
+#endif
+
+	if (!isCreated) {
 		std::ifstream ifs(path, std::ios::binary);
-		std::ofstream ofs(path + ".bak", std::ios::binary);
+		std::ofstream ofs(tmp, std::ios::binary);
 		ofs << ifs.rdbuf();
-	} catch (...) {
+		ofs.close();
+		isCreated = ifs && ofs;
+	}
+
+	if (isCreated) {
+#ifdef _WIN32
+		isCreated = MoveFileExA(tmp.c_str(), bak.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else
+		isCreated = !std::rename(tmp.c_str(), bak.c_str());
+#endif
+	}
+
+	if (!isCreated) {
+		std::remove(tmp.c_str());
 		throw FileOutputError(FileIO::FileType::MOD);
 	}
 }
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <functional>
 #include "module.hpp"
 #include "instruments_manager.hpp"
 #include "binary_container.hpp"
@@ -9,15 +10,27 @@
 class ModuleIO
 {
 public:
+	/// If isCompressed is true, all sections are packed into a compressed section
 	static void saveModule(std::string path, std::weak_ptr<Module> mod,
-						   std::weak_ptr<InstrumentsManager> instMan);
-	static void loadModule(std::string path, std::weak_ptr<Module> mod,
-						   std::weak_ptr<InstrumentsManager> instMan);
+						   std::weak_ptr<InstrumentsManager> instMan, bool isCompressed = false);
+	/// f is called with the loaded and whole size while loading, and cancels loading if it returns true.
+	/// Return false if loading is canceled
+	static bool loadModule(std::string path, std::weak_ptr<Module> mod,
+						   std::weak_ptr<InstrumentsManager> instMan,
+						   std::function<bool(size_t, size_t)> f = nullptr);
 	static void backupModule(std::string path);
 
 private:
 	ModuleIO();
 
+	template <class Container>
+	static void saveSections(Container& ctr, std::weak_ptr<Module> mod,
+							 std::weak_ptr<InstrumentsManager> instMan);
+
+	static bool loadSections(BinaryContainer& ctr, size_t globCsr, size_t eof,
+							 std::weak_ptr<Module> mod, std::weak_ptr<InstrumentsManager> instMan,
+							 uint32_t version, std::function<bool(size_t, size_t)> f);
+
 	static size_t loadModuleSectionInModule(std::weak_ptr<Module> mod, BinaryContainer& ctr,
 											size_t globCsr, uint32_t version);
 	static size_t loadInstrumentSectionInModule(std::weak_ptr<InstrumentsManager> instMan,
@@ -31,6 +44,19 @@ private:
 														 BinaryContainer& ctr, uint32_t version);
 	static size_t loadGrooveSectionInModule(std::weak_ptr<Module> mod, BinaryContainer& ctr,
 											size_t globCsr, uint32_t version);
+	/// f is called with the cursor of ctr while loading, and cancels loading if it returns true.
+	/// Return 0 if loading is canceled
 	static size_t loadSongSectionInModule(std::weak_ptr<Module> mod, BinaryContainer& ctr,
-										  size_t globCsr, uint32_t version);
+										  size_t globCsr, uint32_t version,
+										  std::function<bool(size_t)> f);
+
+	/// Location of pattern steps in the song section
+	struct PatternIndex
+	{
+		Pattern* pattern;
+		int trackIdx;
+		size_t begin, end;
+	};
+	static void loadPatternInModule(const PatternIndex& idx, const BinaryContainer::Span& span,
+									uint32_t version);
 };
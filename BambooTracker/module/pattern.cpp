@@ -1,12 +1,12 @@
 #include "pattern.hpp"
 
 Pattern::Pattern(int n, size_t defSize)
-	: num_(n), size_(defSize), steps_(defSize), usedCnt_(0)
+	: num_(n), size_(defSize), allocSize_(defSize), usedCnt_(0)
 {
 }
 
-Pattern::Pattern(int n, size_t size, std::vector<Step> steps)
-	: num_(n), size_(size), steps_(steps), usedCnt_(0)
+Pattern::Pattern(int n, size_t size, size_t allocSize, std::shared_ptr<StepData> data)
+	: num_(n), size_(size), allocSize_(allocSize), usedCnt_(0), data_(data)
 {
 }
 
@@ -37,15 +37,36 @@ int Pattern::getUsedCount() const
 
 Step& Pattern::getStep(int n)
 {
-	return steps_.at(n);
+	return getMutableData().steps.at(n);
+}
+
+const Step& Pattern::getStep(int n) const
+{
+	if (auto data = std::atomic_load(&data_)) return data->steps.at(n);
+
+	if (n < 0 || static_cast<int>(allocSize_) <= n)
+		throw std::out_of_range("Pattern::getStep");
+	static const Step blank;
+	return blank;
+}
+
+void Pattern::setStepInstrumentNumber(int n, int num)
+{
+	Step& step = getStep(n);
+	countDownInstrument(step.getInstrumentNumber());
+	step.setInstrumentNumber(num);
+	countUpInstrument(num);
 }
 
 size_t Pattern::getSize() const
 {
+	auto data = std::atomic_load(&data_);
+	if (!data) return size_;
+
 	for (size_t i = 0; i < size_; ++i) {
-		if (steps_[i].checkEffectID("0B") != -1
-				|| steps_[i].checkEffectID("0C") != -1
-				|| steps_[i].checkEffectID("0D") != -1)
+		if (data->steps[i].checkEffectID("0B") != -1
+				|| data->steps[i].checkEffectID("0C") != -1
+				|| data->steps[i].checkEffectID("0D") != -1)
 			return i + 1;
 	}
 	return size_;
@@ -55,29 +76,51 @@ void Pattern::changeSize(size_t size)
 {
 	if (0 < size && size <= 256) {
 		size_ = size;
-		if (steps_.size() < size) steps_.resize(size);
+		if (!data_) {
+			if (allocSize_ < size) allocSize_ = size;
+		}
+		else if (data_->steps.size() < size) {
+			getMutableData().steps.resize(size);
+		}
 	}
 }
 
 void Pattern::insertStep(int n)
 {
-	if (n < size_)
-		steps_.emplace(steps_.begin() + n);
+	if (n < size_) {
+		if (!data_) {
+			++allocSize_;	// Insert blank step
+		}
+		else {
+			std::vector<Step>& steps = getMutableData().steps;
+			steps.emplace(steps.begin() + n);
+		}
+	}
 }
 
 void Pattern::deletePreviousStep(int n)
 {
 	if (!n) return;
 
-	steps_.erase(steps_.begin() + n - 1);
-	if (steps_.size() < size_)
-		steps_.resize(size_);
+	if (!data_) {	// Delete blank step
+		if (allocSize_ > size_) --allocSize_;
+		return;
+	}
+
+	std::vector<Step>& steps = getMutableData().steps;
+	countDownInstrument(steps.at(n - 1).getInstrumentNumber());
+	steps.erase(steps.begin() + n - 1);
+	if (steps.size() < size_)
+		steps.resize(size_);
 }
 
 bool Pattern::existCommand() const
 {
+	auto data = std::atomic_load(&data_);
+	if (!data) return false;
+
 	for (size_t i = 0; i < size_; ++i) {
-		if (steps_.at(i).existCommand())
+		if (data->steps.at(i).existCommand())
 			return true;
 	}
 	return false;
@@ -86,8 +129,11 @@ bool Pattern::existCommand() const
 std::vector<int> Pattern::getEditedStepIndices() const
 {
 	std::vector<int> list;
+	auto data = std::atomic_load(&data_);
+	if (!data) return list;
+
 	for (size_t i = 0; i < size_; ++i) {
-		if (steps_.at(i).existCommand())
+		if (data->steps.at(i).existCommand())
 			list.push_back(i);
 	}
 	return list;
@@ -96,19 +142,58 @@ std::vector<int> Pattern::getEditedStepIndices() const
 std::set<int> Pattern::getRegisteredInstruments() const
 {
 	std::set<int> set;
-	for (size_t i = 0; i < size_; ++i) {
-		int n = steps_.at(i).getInstrumentNumber();
-		if (n > -1) set.insert(n);
-	}
+	for (auto& pair : getInstrumentUsedCounts()) set.insert(pair.first);
 	return set;
 }
 
-Pattern Pattern::clone(int asNumber)
+int Pattern::getInstrumentUsedCount(int num) const
 {
-	return Pattern(asNumber, size_, steps_);
+	auto data = std::atomic_load(&data_);
+	if (!data) return 0;
+	auto it = data->instCnts.find(num);
+	return (it == data->instCnts.end()) ? 0 : it->second;
+}
+
+const std::map<int, int>& Pattern::getInstrumentUsedCounts() const
+{
+	static const std::map<int, int> empty;
+	auto data = std::atomic_load(&data_);
+	return data ? data->instCnts : empty;
+}
+
+Pattern Pattern::clone(int asNumber) const
+{
+	return Pattern(asNumber, size_, allocSize_, std::atomic_load(&data_));
 }
 
 void Pattern::clear()
 {
-	steps_ = std::vector<Step>(size_);
+	std::atomic_store(&data_, std::shared_ptr<StepData>());
+	allocSize_ = size_;
+}
+
+Pattern::StepData& Pattern::getMutableData()
+{
+	if (!data_) {
+		auto data = std::make_shared<StepData>();
+		data->steps.resize(allocSize_);
+		std::atomic_store(&data_, data);
+	}
+	else if (data_.use_count() > 1) {
+		std::atomic_store(&data_, std::make_shared<StepData>(*data_));
+	}
+	return *data_;
+}
+
+void Pattern::countUpInstrument(int num)
+{
+	if (num > -1) ++data_->instCnts[num];
+}
+
+void Pattern::countDownInstrument(int num)
+{
+	if (num > -1) {
+		auto it = data_->instCnts.find(num);
+		if (it != data_->instCnts.end() && !--it->second) data_->instCnts.erase(it);
+	}
 }
@@ -2,7 +2,10 @@
 
 #include <vector>
 #include <set>
+#include <map>
 #include <cstddef>
+#include <stdexcept>
+#include <memory>
 #include "step.hpp"
 
 class Pattern
@@ -17,7 +20,21 @@ public:
 	int usedCountDown();
 	int getUsedCount() const;
 
+	/// Step for modification. It separates the steps shared with clones
 	Step& getStep(int n);
+	/// Step for reading. Playback reads steps while the pattern is edited,
+	/// so the step data is loaded atomically. The reference is valid until the next modification
+	const Step& getStep(int n) const;
+	/// Instrument is set through the pattern to keep the usage count
+	void setStepInstrumentNumber(int n, int num);
+	/// Call func(stepNum, step) for each step from begin to end.
+	/// The range is checked once, and instruments must be set by setStepInstrumentNumber
+	template <class Func>
+	void forEachStep(int begin, int end, Func func);
+	/// Call func(stepNum, step) for reading each step from begin to end.
+	/// It does not allocate or separate the steps
+	template <class Func>
+	void forEachStep(int begin, int end, Func func) const;
 
 	size_t getSize() const;
 	void changeSize(size_t size);
@@ -28,16 +45,62 @@ public:
 	bool existCommand() const;
 	std::vector<int> getEditedStepIndices() const;
 	std::set<int> getRegisteredInstruments() const;
+	int getInstrumentUsedCount(int num) const;
+	const std::map<int, int>& getInstrumentUsedCounts() const;
 
-	Pattern clone(int asNumber);
+	/// Steps are shared with the clone until one of them is modified
+	Pattern clone(int asNumber) const;
 
 	void clear();
 
 private:
 	int num_;
 	size_t size_;
-	std::vector<Step> steps_;
+	/// Number of steps allocated when one of them is modified first
+	size_t allocSize_;
 	int usedCnt_;
 
-	Pattern(int n, size_t size, std::vector<Step> steps);
+	struct StepData
+	{
+		std::vector<Step> steps;
+		/// Number of steps using each instrument, including steps out of the pattern size
+		std::map<int, int> instCnts;
+	};
+	/// Shared between clones (copy-on-write). nullptr until a step is modified.
+	/// It is replaced only by the editing thread with std::atomic_store,
+	/// and const members read it with std::atomic_load
+	std::shared_ptr<StepData> data_;
+
+	Pattern(int n, size_t size, size_t allocSize, std::shared_ptr<StepData> data);
+
+	/// Allocate or separate the step data before modification
+	StepData& getMutableData();
+	void countUpInstrument(int num);
+	void countDownInstrument(int num);
 };
+
+template <class Func>
+void Pattern::forEachStep(int begin, int end, Func func)
+{
+	std::vector<Step>& steps = getMutableData().steps;
+	if (begin < 0 || static_cast<int>(steps.size()) <= end)
+		throw std::out_of_range("Pattern::forEachStep");
+	for (int n = begin; n <= end; ++n) func(n, steps[n]);
+}
+
+template <class Func>
+void Pattern::forEachStep(int begin, int end, Func func) const
+{
+	if (auto data = std::atomic_load(&data_)) {
+		const std::vector<Step>& steps = data->steps;
+		if (begin < 0 || static_cast<int>(steps.size()) <= end)
+			throw std::out_of_range("Pattern::forEachStep");
+		for (int n = begin; n <= end; ++n) func(n, steps[n]);
+	}
+	else {
+		if (begin < 0 || static_cast<int>(allocSize_) <= end)
+			throw std::out_of_range("Pattern::forEachStep");
+		const Step blank;
+		for (int n = begin; n <= end; ++n) func(n, blank);
+	}
+}
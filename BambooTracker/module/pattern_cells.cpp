@@ -0,0 +1,137 @@
+#include "pattern_cells.hpp"
+#include <algorithm>
+
+constexpr int PatternCells::COLUMNS_PER_TRACK;
+constexpr size_t PatternCells::MAX_ROWS;
+
+PatternCells::PatternCells()
+	: rows_(0),
+	  cols_(0)
+{
+}
+
+PatternCells::PatternCells(size_t rows, size_t columns)
+	: rows_(rows),
+	  cols_(columns),
+	  cells_(rows * columns, -1)
+{
+}
+
+PatternCells::PatternCells(Song& sng, int order, int beginTrack, int beginColumn, int beginStep,
+						   size_t rows, size_t columns)
+	: rows_(rows),
+	  cols_(columns)
+{
+	cells_.reserve(rows * columns);
+
+	int s = beginStep;
+	for (size_t i = 0; i < rows; ++i) {
+		int t = beginTrack;
+		int c = beginColumn;
+		const Pattern* pattern = &sng.getTrack(t).getPatternFromOrderNumber(order);
+		for (size_t j = 0; j < columns; ++j) {
+			cells_.push_back(readCell(pattern->getStep(s), c));
+
+			++c;
+			if (c == COLUMNS_PER_TRACK && j + 1 < columns) {
+				pattern = &sng.getTrack(++t).getPatternFromOrderNumber(order);
+				c = 0;
+			}
+		}
+		++s;
+	}
+}
+
+size_t PatternCells::getRowCount() const
+{
+	return rows_;
+}
+
+size_t PatternCells::getColumnCount() const
+{
+	return cols_;
+}
+
+int16_t PatternCells::getValue(size_t row, size_t column) const
+{
+	return cells_.at(row * cols_ + column);
+}
+
+void PatternCells::setValue(size_t row, size_t column, int16_t value)
+{
+	cells_.at(row * cols_ + column) = value;
+}
+
+PatternCells PatternCells::cropped(size_t rows, size_t columns) const
+{
+	rows = std::min(rows, rows_);
+	columns = std::min(columns, cols_);
+	PatternCells cells(rows, columns);
+	for (size_t i = 0; i < rows; ++i) {
+		std::copy_n(cells_.begin() + i * cols_, columns, cells.cells_.begin() + i * columns);
+	}
+	return cells;
+}
+
+size_t PatternCells::getMemorySize() const
+{
+	return cells_.capacity() * sizeof(int16_t);
+}
+
+int16_t PatternCells::readCell(const Step& step, int column)
+{
+	switch (column) {
+	case 0:		return static_cast<int16_t>(step.getNoteNumber());
+	case 1:		return static_cast<int16_t>(step.getInstrumentNumber());
+	case 2:		return static_cast<int16_t>(step.getVolume());
+	case 3:		return packEffectID(step.getEffectID(0));
+	case 4:		return static_cast<int16_t>(step.getEffectValue(0));
+	case 5:		return packEffectID(step.getEffectID(1));
+	case 6:		return static_cast<int16_t>(step.getEffectValue(1));
+	case 7:		return packEffectID(step.getEffectID(2));
+	case 8:		return static_cast<int16_t>(step.getEffectValue(2));
+	case 9:		return packEffectID(step.getEffectID(3));
+	case 10:	return static_cast<int16_t>(step.getEffectValue(3));
+	default:	return -1;
+	}
+}
+
+void PatternCells::writeCell(Pattern& pattern, int step, int column, int16_t value)
+{
+	switch (column) {
+	case 0:		pattern.getStep(step).setNoteNumber(value);					break;
+	case 1:		pattern.setStepInstrumentNumber(step, value);				break;
+	case 2:		pattern.getStep(step).setVolume(value);						break;
+	case 3:		pattern.getStep(step).setEffectID(0, unpackEffectID(value));	break;
+	case 4:		pattern.getStep(step).setEffectValue(0, value);				break;
+	case 5:		pattern.getStep(step).setEffectID(1, unpackEffectID(value));	break;
+	case 6:		pattern.getStep(step).setEffectValue(1, value);				break;
+	case 7:		pattern.getStep(step).setEffectID(2, unpackEffectID(value));	break;
+	case 8:		pattern.getStep(step).setEffectValue(2, value);				break;
+	case 9:		pattern.getStep(step).setEffectID(3, unpackEffectID(value));	break;
+	case 10:	pattern.getStep(step).setEffectValue(3, value);				break;
+	default:	break;
+	}
+}
+
+int16_t PatternCells::getBlankValue(int column)
+{
+	static const int16_t BLANK_ID = packEffectID("--");
+	return isEffectIDColumn(column) ? BLANK_ID : -1;
+}
+
+bool PatternCells::isEffectIDColumn(int column)
+{
+	return (column == 3 || column == 5 || column == 7 || column == 9);
+}
+
+int16_t PatternCells::packEffectID(const std::string& id)
+{
+	return static_cast<int16_t>((static_cast<uint8_t>(id.at(0)) << 8) | static_cast<uint8_t>(id.at(1)));
+}
+
+std::string PatternCells::unpackEffectID(int16_t value)
+{
+	uint16_t v = static_cast<uint16_t>(value);
+	return std::string{ static_cast<char>(v >> 8), static_cast<char>(v & 0xff) };
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "song.hpp"
+
+/// Rectangular block of pattern cells used for copy and paste.
+/// Each cell is stored in 2 bytes, and an effect ID is packed into its two characters.
+/// The meaning of a value depends on the column of the pattern it is written to
+class PatternCells
+{
+public:
+	static constexpr int COLUMNS_PER_TRACK = 11;
+	/// Largest pattern size which a song can have
+	static constexpr size_t MAX_ROWS = 256;
+
+	PatternCells();
+	PatternCells(size_t rows, size_t columns);
+	/// Read the range of the song
+	PatternCells(Song& sng, int order, int beginTrack, int beginColumn, int beginStep,
+				 size_t rows, size_t columns);
+
+	size_t getRowCount() const;
+	size_t getColumnCount() const;
+	int16_t getValue(size_t row, size_t column) const;
+	void setValue(size_t row, size_t column, int16_t value);
+	/// Upper left part of the block
+	PatternCells cropped(size_t rows, size_t columns) const;
+	/// Bytes allocated for the cells
+	size_t getMemorySize() const;
+
+	/// column: column in a track
+	static int16_t readCell(const Step& step, int column);
+	static void writeCell(Pattern& pattern, int step, int column, int16_t value);
+	static int16_t getBlankValue(int column);
+	static bool isEffectIDColumn(int column);
+	static int16_t packEffectID(const std::string& id);
+	static std::string unpackEffectID(int16_t value);
+
+private:
+	size_t rows_, cols_;
+	std::vector<int16_t> cells_;
+};
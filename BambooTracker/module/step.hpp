@@ -11,7 +11,6 @@ public:
 	void setNoteNumber(int num);
 
 	int getInstrumentNumber() const;
-	void setInstrumentNumber(int num);
 
 	int getVolume() const;
 	void setVolume(int volume);
@@ -27,6 +26,10 @@ public:
 	bool existCommand() const;
 
 private:
+	friend class Pattern;
+	/// Use Pattern::setStepInstrumentNumber to keep the instrument usage count of the pattern
+	void setInstrumentNumber(int num);
+
 	/// noteNum_
 	///		0<=: note number (key on)
 	///		 -1: none
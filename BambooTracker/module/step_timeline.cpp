@@ -0,0 +1,54 @@
+#include "step_timeline.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+StepTimeline::StepTimeline()
+	: offsets_{ 0 }
+{
+}
+
+StepTimeline::StepTimeline(Song& song)
+{
+	std::vector<TrackAttribute> attribs = song.getTrackAttributes();
+	size_t odrSize = song.getOrderSize();
+	offsets_.reserve(odrSize + 1);
+	offsets_.push_back(0);
+	for (size_t o = 0; o < odrSize; ++o) {
+		size_t size = 0;
+		for (auto& attrib : attribs) {
+			const Pattern& ptn = song.getTrack(attrib.number).getPatternFromOrderNumber(o);
+			size = (!size) ? ptn.getSize() : std::min(size, ptn.getSize());
+		}
+		offsets_.push_back(offsets_.back() + size);
+	}
+}
+
+size_t StepTimeline::getOrderSize() const
+{
+	return offsets_.size() - 1;
+}
+
+size_t StepTimeline::getPatternSize(int order) const
+{
+	return offsets_.at(order + 1) - offsets_.at(order);
+}
+
+size_t StepTimeline::getStepCount() const
+{
+	return offsets_.back();
+}
+
+size_t StepTimeline::getAbsoluteStep(int order, int step) const
+{
+	return offsets_.at(order) + step;
+}
+
+std::pair<int, int> StepTimeline::getPosition(size_t absStep) const
+{
+	if (absStep >= offsets_.back()) throw std::out_of_range("StepTimeline::getPosition");
+
+	// First order whose end is beyond the step
+	auto it = std::upper_bound(offsets_.begin() + 1, offsets_.end(), absStep);
+	int order = static_cast<int>(it - offsets_.begin()) - 1;
+	return std::make_pair(order, static_cast<int>(absStep - offsets_[order]));
+}
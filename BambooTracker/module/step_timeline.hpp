@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include "song.hpp"
+
+/// Positions of all steps of a song laid out from the first order.
+/// It keeps prefix sums of the pattern sizes of orders,
+/// so it must be rebuilt when orders or patterns of the song are edited
+class StepTimeline
+{
+public:
+	StepTimeline();
+	explicit StepTimeline(Song& song);
+
+	size_t getOrderSize() const;
+	/// Same as the size of the shortest pattern in the order
+	size_t getPatternSize(int order) const;
+	size_t getStepCount() const;
+
+	/// Step number counted from the first step of the song.
+	/// order can be the order size to get the end of the song
+	size_t getAbsoluteStep(int order, int step) const;
+	/// Order and step numbers of the step counted from the first step of the song.
+	/// absStep must be less than the step count
+	std::pair<int, int> getPosition(size_t absStep) const;
+
+private:
+	/// offsets_[i] is the number of steps before order i, and the last element is the step count
+	std::vector<size_t> offsets_;
+};
@@ -88,8 +88,8 @@ std::set<int> Track::getRegisteredInstruments() const
 {
 	std::set<int> set;
 	for (auto& pattern : patterns_) {
-		for (auto& n : pattern.getRegisteredInstruments()) {
-			set.insert(n);
+		for (auto& pair : pattern.getInstrumentUsedCounts()) {
+			set.insert(pair.first);
 		}
 	}
 	return set;
@@ -102,6 +102,15 @@ void Track::registerPatternToOrder(int order, int pattern)
 	order_.at(order) = pattern;
 }
 
+void Track::setOrders(const std::vector<int>& patterns)
+{
+	if (patterns.empty()) return;
+
+	for (auto& n : patterns) patterns_.at(n).usedCountUp();
+	for (auto& n : order_) patterns_[n].usedCountDown();
+	order_ = patterns;
+}
+
 void Track::insertOrderBelow(int order)
 {
 	int n = searchFirstUneditedUnusedPattern();
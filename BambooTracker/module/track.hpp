@@ -13,6 +13,7 @@ class Track
 {
 public:
 	Track(int number, SoundSource source, int channelInSource, int defPattenSize);
+	/// Patterns share their steps with the copy until one of them is modified
 	Track(const Track& other);
 	TrackAttribute getAttribute() const;
 	OrderData getOrderData(int order);
@@ -25,6 +26,7 @@ public:
 	std::set<int> getRegisteredInstruments() const;
 
 	void registerPatternToOrder(int order, int pattern);
+	void setOrders(const std::vector<int>& patterns);
 	void insertOrderBelow(int order);
 	void deleteOrder(int order);
 	void swapOrder(int a, int b);
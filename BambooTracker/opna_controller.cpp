@@ -1,11 +1,12 @@
 #include "opna_controller.hpp"
 #include "pitch_converter.hpp"
 
-OPNAController::OPNAController(int clock, int rate, int duration)
+OPNAController::OPNAController(int clock, int rate, int duration, chip::SSGEmulator ssgEmulator)
 {	
 	opna_ = std::make_unique<chip::OPNA>(clock, rate, duration,
 										 std::make_unique<chip::LinearResampler>(),
-										 std::make_unique<chip::LinearResampler>());
+										 std::make_unique<chip::LinearResampler>(),
+										 nullptr, ssgEmulator);
 
 	for (int ch = 0; ch < 6; ++ch) {
 		opSeqItFM_[ch].emplace(FMEnvelopeParameter::AL, nullptr);
@@ -130,6 +131,11 @@ void OPNAController::setMasterVolume(int percentage)
 	opna_->setMasterVolume(percentage);
 }
 
+void OPNAController::setMixMode(chip::MixMode mode)
+{
+	opna_->setMixMode(mode);
+}
+
 void OPNAController::setExportContainer(std::shared_ptr<chip::ExportContainerInterface> cntr)
 {
 	opna_->setExportContainer(cntr);
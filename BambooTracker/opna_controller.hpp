@@ -26,7 +26,8 @@ struct ToneNoise
 class OPNAController
 {
 public:
-	OPNAController(int clock, int rate, int duration);
+	OPNAController(int clock, int rate, int duration,
+				   chip::SSGEmulator ssgEmulator = chip::SSGEmulator::EMU2149);
 
 	// Reset and initialize
 	void reset();
@@ -47,6 +48,7 @@ public:
 	int getDuration() const;
 	void setDuration(int duration);
 	void setMasterVolume(int percentage);
+	void setMixMode(chip::MixMode mode);
 
 	// Export
 	void setExportContainer(std::shared_ptr<chip::ExportContainerInterface> cntr = nullptr);
@@ -67,6 +69,8 @@ public:
 	void updateEchoBufferFM(int ch, int octave, Note note, int pitch);
 
 	// Set Instrument
+	/// The instrument is the live one in InstrumentsManager, not a snapshot.
+	/// The stream is pulled and the song is played in the thread which edits instruments
 	void setInstrumentFM(int ch, std::shared_ptr<InstrumentFM> inst);
 	void updateInstrumentFM(int instNum);
 	void updateInstrumentFMEnvelopeParameter(int envNum, FMEnvelopeParameter param);
@@ -176,6 +180,7 @@ public:
 	void updateEchoBufferSSG(int ch, int octave, Note note, int pitch);
 
 	// Set Instrument
+	/// The instrument is the live one as with FM
 	void setInstrumentSSG(int ch, std::shared_ptr<InstrumentSSG> inst);
 	void updateInstrumentSSG(int instNum);
 
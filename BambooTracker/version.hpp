@@ -12,6 +12,8 @@ public:
 
 	static uint32_t ofModuleFileInBCD();
 	static std::string ofModuleFileInString();
+	/// Last module file version without packed sections
+	static uint32_t ofUncompressedModuleFileInBCD();
 
 	static uint32_t ofInstrumentFileInBCD();
 	static std::string ofInstrumentFileInString();
@@ -28,7 +30,8 @@ private:
 	// Module file version
 	static constexpr unsigned int modFileMajor		= 1;
 	static constexpr unsigned int modFileMinor		= 0;
-	static constexpr unsigned int modFileRevision	= 2;
+	static constexpr unsigned int modFileRevision	= 3;
+	static constexpr unsigned int modFileUncompressedRevision	= 2;
 
 	// Instrument file version
 	static constexpr unsigned int instFileMajor		= 1;
@@ -58,6 +61,11 @@ inline std::string Version::ofModuleFileInString()
 	return toString(modFileMajor, modFileMinor, modFileRevision);
 }
 
+inline uint32_t Version::ofUncompressedModuleFileInBCD()
+{
+	return toBCD(modFileMajor, modFileMinor, modFileUncompressedRevision);
+}
+
 inline uint32_t Version::ofInstrumentFileInBCD()
 {
 	return toBCD(instFileMajor, instFileMinor, instFileRevision);